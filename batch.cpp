@@ -0,0 +1,249 @@
+/**************************************************************
+ * File:		batch.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The module of the batch of the observers of the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    batch.cpp
+ * @brief   This module contains the implementation of the batch of the observers placed
+ *          along the same line of sight. The altitudes are loaded to the processes only
+ *          once and the observers are solved by the blocks of BATCH_BLOCK observers. The
+ *          window of each process is streamed by the tiles of BATCH_TILE altitudes and
+ *          all observers of the block are swept over the tile, while it is in the cache.
+ *          The offsets of all observers of the block are exchanged by one exclusive scan
+ *          in each direction.
+ */
+
+
+#include "vid.h"
+
+
+bool parse_observers(const char *list, std::vector<long long> *observers) {
+    observers->clear();
+    // The list consists of the non-negative indices delimited by the commas
+    const char *position = list;
+    while (true) {
+        // Each index starts by the digit, thus no sign nor white space is accepted
+        if (!isdigit((unsigned char) *position)) {
+            return false;
+        }
+        char *end;
+        long long observer = strtoll(position, &end, 10);
+        observers->push_back(observer);
+        if (!*end) {
+            return true;
+        }
+        if (*end != ',') {
+            return false;
+        }
+        position = end + 1;
+    }
+}
+
+/**
+ * Obtains the altitudes of the given observers, each altitude is contributed by the process,
+ * which window contains the observer.
+ */
+template <typename altitude_t>
+static void observer_altitudes(
+    const altitude_t *node_part, const long long *observers, int block, int *altitudes, const layout_t *layout
+) {
+    // Index of the first altitude of the process window
+    long long first = layout->node_first + layout->start_idx;
+    for (int i = 0; i < block; i++) {
+        altitudes[i] = INT_MIN;
+        if (observers[i] >= first && observers[i] < first + layout->window_size) {
+            altitudes[i] = node_part[observers[i] - layout->node_first];
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, altitudes, block, MPI_INT, MPI_MAX, layout->comm);
+}
+
+/**
+ * Computes the exclusive max-scan of the maximums of all observers of the block at once,
+ * the result is the neutral element on the first process of the communicator.
+ */
+static void exclusive_block_max(const slope_t *maximums, slope_t *offsets, int block, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    // Create the operation computing the maximum of the slopes (commutative)
+    MPI_Op slope_max_op;
+    MPI_Op_create(&slope_max_operation, true, &slope_max_op);
+    MPI_Exscan(maximums, offsets, block, MPI_2INT, slope_max_op, comm);
+    // The result of the exclusive scan is undefined on the first process
+    if (rank == MASTER) {
+        std::fill(offsets, offsets + block, SLOPE_MIN);
+    }
+    MPI_Op_free(&slope_max_op);
+}
+
+template <typename altitude_t>
+static void solve_observer_block(
+    const altitude_t *window, const long long *observers, const int *altitudes, int block, uint64_t *results,
+    size_t words, MPI_Comm forward_comm, MPI_Comm mirror_comm, const layout_t *layout
+) {
+    // Indices of the first altitude of the process window and of the altitude after it
+    long long first = layout->node_first + layout->start_idx, last = first + layout->window_size;
+    // Maximums of the slopes after each observer and before it within the window and their offsets
+    std::vector<slope_t> right(block, SLOPE_MIN), left(block, SLOPE_MIN), right_offset(block), left_offset(block);
+
+    // The first pass: the maximums of the slopes of all observers are reduced tile by tile
+    for (long long tile = first; tile < last; tile += BATCH_TILE) {
+        long long tile_end = std::min(last, tile + BATCH_TILE);
+        for (int i = 0; i < block; i++) {
+            long long observer = observers[i];
+            // The part of the tile after the observer and the part before it
+            long long right_first = std::max(tile, observer + 1), left_end = std::min(tile_end, observer);
+            if (right_first < tile_end) {
+                right[i] = max_altitude_slope(
+                        window + (right_first - first), altitudes[i], right_first - observer, tile_end - right_first,
+                        right[i]
+                );
+            }
+            if (tile < left_end) {
+                left[i] = max_altitude_slope_backward(
+                        window + (tile - first), altitudes[i], observer - left_end + 1, left_end - tile, left[i]
+                );
+            }
+        }
+    }
+    // The maximums of the preceding windows after the observers and of the following windows before them
+    exclusive_block_max(right.data(), right_offset.data(), block, forward_comm);
+    exclusive_block_max(left.data(), left_offset.data(), block, mirror_comm);
+
+    // The second pass: the tiles after the observers are swept forward, the tiles before them backward
+    std::fill(results, results + block * words, 0);
+    for (long long tile = first; tile < last; tile += BATCH_TILE) {
+        long long tile_end = std::min(last, tile + BATCH_TILE);
+        for (int i = 0; i < block; i++) {
+            long long right_first = std::max(tile, observers[i] + 1);
+            if (right_first < tile_end) {
+                right_offset[i] = sweep_slopes(
+                        window + (right_first - first), altitudes[i], right_first - observers[i],
+                        tile_end - right_first, right_offset[i], results + i * words, right_first - first
+                );
+            }
+        }
+    }
+    for (long long tile = first + (std::max(layout->window_size - 1, 0) / BATCH_TILE) * BATCH_TILE; tile >= first;
+         tile -= BATCH_TILE) {
+        long long tile_end = std::min(last, tile + BATCH_TILE);
+        for (int i = 0; i < block; i++) {
+            long long left_end = std::min(tile_end, observers[i]);
+            if (tile < left_end) {
+                left_offset[i] = sweep_slopes_backward(
+                        window + (tile - first), altitudes[i], observers[i] - left_end + 1, left_end - tile,
+                        left_offset[i], results + i * words, tile - first
+                );
+            }
+        }
+    }
+}
+
+template <typename altitude_t>
+static int solve_observer_batch(
+    const altitude_t *node_part, const std::vector<long long> *observers, const settings_t *settings,
+    const layout_t *layout
+) {
+    // Returns the number of all processes and the position of the process within their sequence
+    int processes, position = layout->node_position + layout->rank;
+    MPI_Comm_size(layout->comm, &processes);
+    // Communicators of all processes in the order of their positions and in the reverse order
+    MPI_Comm forward_comm, mirror_comm;
+    MPI_Comm_split(layout->comm, 0, position, &forward_comm);
+    MPI_Comm_split(layout->comm, 0, processes - 1 - position, &mirror_comm);
+    // The process window starts at the begin of the word, thus its results are the contiguous words
+    size_t words = RESULT_WORDS(layout->window_size);
+    int first_word = (layout->node_first + layout->start_idx) / WORD_BITS;
+    std::vector<uint64_t> results(BATCH_BLOCK * words), gathered;
+    // Master process obtains the words of the results of all processes to gather the bitsets
+    std::vector<int> counts, displacements;
+    if (settings->output == OUTPUT_RAW) {
+        int local_words = words;
+        if (layout->world_rank == MASTER) {
+            counts.resize(processes);
+            displacements.resize(processes);
+            gathered.resize(RESULT_WORDS(layout->total_altitudes));
+        }
+        MPI_Gather(&local_words, COUNT, MPI_INT, counts.data(), COUNT, MPI_INT, MASTER, layout->comm);
+        MPI_Gather(&first_word, COUNT, MPI_INT, displacements.data(), COUNT, MPI_INT, MASTER, layout->comm);
+    }
+
+    bool written = true;
+    const altitude_t *window = node_part + layout->start_idx;
+    int altitudes[BATCH_BLOCK];
+    long long visible[BATCH_BLOCK];
+    for (size_t begin = 0; begin < observers->size(); begin += BATCH_BLOCK) {
+        int block = std::min((size_t) BATCH_BLOCK, observers->size() - begin);
+        const long long *block_observers = observers->data() + begin;
+        observer_altitudes(node_part, block_observers, block, altitudes, layout);
+        solve_observer_block(
+                window, block_observers, altitudes, block, results.data(), words, forward_comm, mirror_comm, layout
+        );
+        if (settings->output == OUTPUT_RAW) {
+            // Master process writes out the whole bitset of each observer
+            for (int i = 0; i < block; i++) {
+                MPI_Gatherv(
+                        results.data() + i * words, words, MPI_UINT64_T, gathered.data(), counts.data(),
+                        displacements.data(), MPI_UINT64_T, MASTER, layout->comm
+                );
+                if (layout->world_rank == MASTER) {
+                    written = written && write_raw(stdout, gathered.data(), layout->total_altitudes);
+                }
+            }
+            continue;
+        }
+        // Only the numbers of the visible points of the observers are reduced to the master process
+        for (int i = 0; i < block; i++) {
+            visible[i] = 0;
+            for (size_t word = 0; word < words; word++) {
+                visible[i] += __builtin_popcountll(results[i * words + word]);
+            }
+        }
+        MPI_Reduce(
+                (layout->world_rank == MASTER) ? MPI_IN_PLACE : visible, visible, block, MPI_LONG_LONG, MPI_SUM,
+                MASTER, layout->comm
+        );
+        if (layout->world_rank == MASTER) {
+            for (int i = 0; i < block; i++) {
+                written = written && fprintf(stdout, "%lld %lld\n", block_observers[i], visible[i]) > 0;
+            }
+        }
+    }
+    MPI_Comm_free(&forward_comm);
+    MPI_Comm_free(&mirror_comm);
+    // The master process writes out the error of the output, the other processes have nothing to report
+    written = written && !fflush(stdout);
+    if (!written) {
+        report_error("cannot write out the results", layout->world_rank);
+        return 1;
+    }
+    return 0;
+}
+
+int solve_observers(const void *node_part, uint32_t element_type, const settings_t *settings, const layout_t *layout) {
+    // The list of the observers was validated by the parsing of the arguments
+    std::vector<long long> observers;
+    parse_observers(settings->observers, &observers);
+    for (long long observer : observers) {
+        if (observer >= layout->total_altitudes) {
+            report_error("the observer is out of the line of sight", layout->world_rank);
+            return 1;
+        }
+    }
+    // Select the specialization of the batch reading the altitudes directly in their stored type
+    switch (element_type) {
+        case altitude_traits<int16_t>::element_type:
+            return solve_observer_batch((const int16_t *) node_part, &observers, settings, layout);
+        default:
+            return solve_observer_batch((const int *) node_part, &observers, settings, layout);
+    }
+}
@@ -0,0 +1,238 @@
+/**************************************************************
+ * File:		bench.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The benchmark module of the program implementing Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    bench.cpp
+ * @brief   This module contains the implementation of the benchmark suite, which runs
+ *          all phases of the pipeline repeatedly within the one run of the program. The
+ *          synthetic terrains are generated for the sizes from BENCH_MIN_SIZE up to
+ *          BENCH_MAX_SIZE and the pipeline runs on the power-of-two numbers of the
+ *          processes. The median and the 99th percentile of each phase are written out
+ *          as the JSON document together with the bandwidth of the reads from the pages
+ *          placed by their owners and from the pages interleaved over the node.
+ */
+
+
+#include "vid.h"
+
+#include <string>
+
+
+// Names of the synthetic terrains, indexed by the TERRAIN_* constants
+static const char *terrain_names[TERRAINS] = {"random", "monotone", "worst"};
+// Names of the measured phases, indexed by the PHASE_* constants
+static const char *phase_names[PHASES] = {"load", "share", "angles", "prescan", "results", "gather", "output"};
+
+void generate_terrain(int terrain, int total_altitudes, std::string *line) {
+    line->clear();
+    unsigned int seed = 1;
+    for (long long i = 0; i < total_altitudes; i++) {
+        long long altitude;
+        switch (terrain) {
+            // Uniformly distributed altitudes, the visible points are rare
+            case TERRAIN_RANDOM:
+                seed = seed * 1103515245 + 12345;
+                altitude = (seed >> 16) % 10000;
+                break;
+            // Constantly rising terrain, all points have the same slope
+            case TERRAIN_MONOTONE:
+                altitude = i;
+                break;
+            // Convex terrain, the slopes grow with the distance and nearly all points are visible
+            default:
+                altitude = (i * i) >> 20;
+                break;
+        }
+        *line += std::to_string(altitude);
+        line->push_back(',');
+    }
+    // The last altitude is not followed by the comma
+    line->pop_back();
+}
+
+/**
+ * Selects the value of the given percentile from the sorted samples (the nearest rank).
+ */
+static double percentile(const std::vector<double> *samples, double fraction) {
+    size_t rank = (size_t) ceil(fraction * samples->size());
+    return (*samples)[rank ? rank - 1 : 0];
+}
+
+void benchmark_pipeline(
+    const text_t *text, const settings_t *settings, layout_t *layout, std::vector<double> *times
+) {
+    // Shared windows of the altitudes and of the pipeline, the angles are always stored
+    int *shared_altitudes, observer_altitude;
+    MPI_Win node_altitudes;
+    windows_t windows;
+    std::vector<long long> firsts;
+    std::vector<uint64_t> gathered;
+    // Time of the end of the previous phase, all processes finish each phase before its end is measured
+    MPI_Barrier(layout->comm);
+    double previous = MPI_Wtime();
+    auto phase_end = [&](int phase) {
+        MPI_Barrier(layout->comm);
+        double now = MPI_Wtime();
+        (*times)[phase] = (now - previous) * 1e6;
+        previous = now;
+    };
+
+    count_points_to_process(text, &firsts, &observer_altitude, layout);
+    phase_end(PHASE_LOAD);
+    share_points_to_process(&shared_altitudes, &node_altitudes, text, &firsts, layout);
+    phase_end(PHASE_SHARE);
+    // The allocation of the windows of the pipeline is not measured
+    allocate_windows(&windows, settings, layout);
+    if (settings->scan == SCAN_LOOKBACK) {
+        init_scan_status(windows.status + layout->rank, layout->node_comm);
+    }
+    MPI_Barrier(layout->comm);
+    previous = MPI_Wtime();
+    compute_angles(
+            shared_altitudes, &windows.shared_angles, &windows.max_previous_angles, windows.node_angles,
+            windows.node_prev_angles, observer_altitude, layout
+    );
+    phase_end(PHASE_ANGLES);
+    prescan_angles(&windows, settings, layout);
+    phase_end(PHASE_PRESCAN);
+    compute_results(
+            &windows.shared_angles, &windows.max_previous_angles, &windows.result, windows.node_angles,
+            windows.node_prev_angles, windows.node_results, layout
+    );
+    phase_end(PHASE_RESULTS);
+    gather_results(&windows.result, windows.node_results, &gathered, layout);
+    phase_end(PHASE_GATHER);
+    // The results are formatted as by the normal run, but they are discarded
+    if (layout->world_rank == MASTER) {
+        FILE *null = fopen("/dev/null", "w");
+        write_text(null, windows.result, layout->total_altitudes, 0);
+        fclose(null);
+    }
+    phase_end(PHASE_OUTPUT);
+
+    MPI_Win_free(&node_altitudes);
+    free_windows(&windows, settings);
+}
+
+double placement_bandwidth(bool interleaved, const layout_t *layout) {
+    // Each process owns the region of the window, the whole window is allocated by the master process
+    MPI_Win node_region;
+    char *base;
+    size_t region = PLACEMENT_BYTES, pages = region * layout->size / PAGE_ALIGN;
+    MPI_Win_allocate_shared(
+            (layout->rank == MASTER) ? region * layout->size + PAGE_ALIGN : 0, 1, MPI_INFO_NULL, layout->node_comm,
+            &base, &node_region
+    );
+    base = (char *) query_node_base(node_region, PAGE_ALIGN);
+    // The first touch of each page places it on the NUMA node of the touching process
+    for (size_t page = 0; page < pages; page++) {
+        size_t owner = interleaved ? page % layout->size : page / (region / PAGE_ALIGN);
+        if (owner == (size_t) layout->rank) {
+            memset(base + page * PAGE_ALIGN, 1, PAGE_ALIGN);
+        }
+    }
+    // Each process reads its own region repeatedly, the sum of the words prevents the elimination of the reads
+    const uint64_t *words = (const uint64_t *) (base + layout->rank * region);
+    volatile uint64_t sink = 0;
+    MPI_Barrier(layout->comm);
+    double start = MPI_Wtime();
+    for (int read = 0; read < PLACEMENT_READS; read++) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < region / WORD_UNIT; i++) {
+            sum += words[i];
+        }
+        sink = sink + sum;
+    }
+    // The bandwidth is limited by the slowest process
+    double elapsed = MPI_Wtime() - start;
+    MPI_Allreduce(MPI_IN_PLACE, &elapsed, COUNT, MPI_DOUBLE, MPI_MAX, layout->comm);
+    int processes;
+    MPI_Comm_size(layout->comm, &processes);
+    MPI_Win_free(&node_region);
+    return (double) region * PLACEMENT_READS * processes / elapsed / 1e9;
+}
+
+int run_benchmark(const settings_t *settings, layout_t *layout) {
+    // Returns the number of all processes
+    int processes;
+    MPI_Comm_size(MPI_COMM_WORLD, &processes);
+    // The benchmark measures the pipeline with the stored angles and the selected engine of the max-prescan
+    settings_t bench_settings = *settings;
+    bench_settings.fused = false;
+    layout->observer = 0;
+    // The measured processes are the powers of two and all processes
+    std::vector<int> counts;
+    for (int p = 1; p < processes; p *= 2) {
+        counts.push_back(p);
+    }
+    counts.push_back(processes);
+
+    // Bandwidth of the reads from the pages placed by their owners and from the pages interleaved over the node
+    double local = placement_bandwidth(false, layout), interleaved = placement_bandwidth(true, layout);
+    if (layout->world_rank == MASTER) {
+        printf("{\"repetitions\": %d, \"scan\": \"%s\", \"placement\": {\"local_gbps\": %.3f, "
+               "\"interleaved_gbps\": %.3f}, \"runs\": [", settings->benchmark,
+               (settings->scan == SCAN_LOOKBACK) ? "lookback" : "tree", local, interleaved);
+    }
+    std::string line;
+    bool first_run = true;
+    for (int terrain = 0; terrain < TERRAINS; terrain++) {
+        for (int total = BENCH_MIN_SIZE; total <= BENCH_MAX_SIZE; total *= BENCH_SIZE_STEP) {
+            // Each process generates the same line of sight, the generation is not measured
+            generate_terrain(terrain, total, &line);
+            text_t text = {nullptr, 0, line.data(), line.size()};
+            for (int active : counts) {
+                // Only the given number of the processes participates in the pipeline
+                layout_t bench_layout = *layout;
+                MPI_Comm_split(
+                        MPI_COMM_WORLD, (layout->world_rank < active) ? 0 : MPI_UNDEFINED, layout->world_rank,
+                        &bench_layout.comm
+                );
+                std::vector<std::vector<double>> samples(PHASES);
+                if (bench_layout.comm != MPI_COMM_NULL) {
+                    split_to_nodes(&bench_layout);
+                    std::vector<double> times(PHASES);
+                    for (int repetition = 0; repetition < settings->benchmark; repetition++) {
+                        benchmark_pipeline(&text, &bench_settings, &bench_layout, &times);
+                        for (int phase = 0; phase < PHASES; phase++) {
+                            samples[phase].push_back(times[phase]);
+                        }
+                    }
+                    if (bench_layout.leaders_comm != MPI_COMM_NULL) {
+                        MPI_Comm_free(&bench_layout.leaders_comm);
+                    }
+                    MPI_Comm_free(&bench_layout.node_comm);
+                    MPI_Comm_free(&bench_layout.comm);
+                }
+                // Master process writes out the median and the 99th percentile of each phase in microseconds
+                if (layout->world_rank == MASTER) {
+                    printf("%s\n  {\"terrain\": \"%s\", \"n\": %d, \"p\": %d, \"phases\": {",
+                           first_run ? "" : ",", terrain_names[terrain], total, active);
+                    for (int phase = 0; phase < PHASES; phase++) {
+                        std::sort(samples[phase].begin(), samples[phase].end());
+                        printf("%s\"%s\": {\"median_us\": %.3f, \"p99_us\": %.3f}", phase ? ", " : "",
+                               phase_names[phase], percentile(&samples[phase], 0.5),
+                               percentile(&samples[phase], 0.99));
+                    }
+                    printf("}}");
+                }
+                first_run = false;
+            }
+        }
+    }
+    if (layout->world_rank == MASTER) {
+        printf("\n]}\n");
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**************************************************************
+ * File:		incremental.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The module of the incremental engine used by the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    incremental.cpp
+ * @brief   This module contains the implementation of the incremental engine, which
+ *          recomputes only the blocks of the line of sight affected by the change.
+ */
+
+#include "incremental.h"
+
+#include <algorithm>
+
+/**
+ * Compares the slopes on the equality of both their numerators and denominators.
+ */
+static bool slope_same(slope_t a, slope_t b) {
+    return a.num == b.num && a.den == b.den;
+}
+
+/**
+ * Recomputes the results of the given block from its cached prefix.
+ */
+static void sweep_block(incremental_t *engine, size_t block) {
+    // Range of the altitudes of the block, the block starts at the begin of the word
+    size_t first = block * INCREMENTAL_BLOCK;
+    size_t count = std::min((size_t) INCREMENTAL_BLOCK, engine->altitudes.size() - first);
+    // The bits of the block are combined to the words, thus they are cleared first
+    std::fill(
+            engine->result.begin() + first / WORD_BITS,
+            engine->result.begin() + (first + count + WORD_BITS - 1) / WORD_BITS, 0
+    );
+    sweep_slopes(
+            engine->altitudes.data() + first, engine->altitudes[0], first, count, engine->prefix[block],
+            engine->result.data(), first
+    );
+}
+
+void incremental_append(incremental_t *engine, const int *altitudes, size_t count) {
+    // Number of the altitudes before the appending
+    size_t total = engine->altitudes.size();
+    engine->altitudes.insert(engine->altitudes.end(), altitudes, altitudes + count);
+    engine->result.resize((total + count + WORD_BITS - 1) / WORD_BITS, 0);
+    // Process the appended altitudes by the parts within the individual blocks
+    for (size_t i = total, end; i < total + count; i = end) {
+        size_t block = i / INCREMENTAL_BLOCK;
+        end = std::min((block + 1) * INCREMENTAL_BLOCK, total + count);
+        // The new block starts with the maximum of all preceding blocks
+        if (block == engine->block_max.size()) {
+            engine->prefix.push_back(
+                    block ? slope_max(engine->prefix[block - 1], engine->block_max[block - 1]) : SLOPE_MIN
+            );
+            engine->block_max.push_back(SLOPE_MIN);
+        }
+        // The appended part of the block continues from the maximum of all preceding slopes
+        const int *part = engine->altitudes.data() + i;
+        sweep_slopes(
+                part, engine->altitudes[0], i, end - i, slope_max(engine->prefix[block], engine->block_max[block]),
+                engine->result.data(), i
+        );
+        engine->block_max[block] = max_altitude_slope(part, engine->altitudes[0], i, end - i, engine->block_max[block]);
+    }
+}
+
+size_t incremental_set(incremental_t *engine, size_t index, int altitude) {
+    engine->altitudes[index] = altitude;
+    size_t blocks = engine->block_max.size(), block = index / INCREMENTAL_BLOCK;
+    // The change of the observer changes all slopes, thus the whole line of sight is processed again
+    if (index == 0) {
+        std::vector<int> altitudes;
+        altitudes.swap(engine->altitudes);
+        engine->block_max.clear();
+        engine->prefix.clear();
+        engine->result.clear();
+        incremental_append(engine, altitudes.data(), altitudes.size());
+        return blocks;
+    }
+    // Recompute the maximum and the results of the block with the changed altitude
+    size_t first = block * INCREMENTAL_BLOCK;
+    engine->block_max[block] = max_altitude_slope(
+            engine->altitudes.data() + first, engine->altitudes[0], first,
+            std::min((size_t) INCREMENTAL_BLOCK, engine->altitudes.size() - first), SLOPE_MIN
+    );
+    sweep_block(engine, block);
+    size_t recomputed = 1;
+    // Propagate the changed maximum to the following blocks until their prefix stops changing
+    for (size_t next = block + 1; next < blocks; next++) {
+        slope_t prefix = slope_max(engine->prefix[next - 1], engine->block_max[next - 1]);
+        if (slope_same(prefix, engine->prefix[next])) {
+            break;
+        }
+        // The block, which maximum does not exceed both prefixes, has all points hidden in both cases
+        bool hidden = !slope_greater(engine->block_max[next], prefix) &&
+                      !slope_greater(engine->block_max[next], engine->prefix[next]);
+        engine->prefix[next] = prefix;
+        if (!hidden) {
+            sweep_block(engine, next);
+            recomputed++;
+        }
+    }
+    return recomputed;
+}
@@ -0,0 +1,74 @@
+/**************************************************************
+ * File:		incremental.h
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The header module of the incremental engine used by the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    incremental.h
+ * @brief   The header module contains the declarations of the incremental engine, which
+ *          keeps the results of the growing line of sight up to date. The altitudes are
+ *          split to the blocks, the engine caches the maximum slope of each block and the
+ *          maximum of all slopes preceding it (the max-prescan of the block maximums).
+ *          Thus the appended altitudes are processed in O(k) and the change of one
+ *          altitude recomputes only the blocks, which prefix has really changed.
+ */
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "kernel.h"
+
+// Number of the altitudes of the one block of the incremental engine (multiple of WORD_BITS)
+#define INCREMENTAL_BLOCK 4096
+
+/**
+ * The state of the incremental engine. The observer is placed at the first altitude.
+ */
+typedef struct incremental {
+    // All altitudes of the line of sight
+    std::vector<int> altitudes;
+    // Maximum slope within each block
+    std::vector<slope_t> block_max;
+    // Maximum slope of all blocks preceding each block (exclusive max-prescan of the block maximums)
+    std::vector<slope_t> prefix;
+    // Bitset of the visibilities of all points
+    std::vector<uint64_t> result;
+} incremental_t;
+
+/**
+ * Appends the given altitudes to the end of the line of sight. Only the appended altitudes
+ * are processed, they continue from the cached maximum of the preceding slopes.
+ *
+ * @param engine        state of the incremental engine
+ * @param altitudes     appended altitudes
+ * @param count         number of the appended altitudes
+ */
+void incremental_append(incremental_t *engine, const int *altitudes, size_t count);
+
+/**
+ * Changes the altitude of the given point. The block of the point is recomputed and the
+ * changed maximum is propagated to the following blocks until the prefix of the block
+ * stops changing. The block, which maximum does not exceed both old and new prefix, keeps
+ * its results (all its points are hidden), thus it is passed in O(1). The change of the
+ * observer changes all slopes, thus all blocks are recomputed.
+ *
+ * @param engine        state of the incremental engine
+ * @param index         index of the changed altitude (less than the number of the altitudes)
+ * @param altitude      new altitude of the point
+ * @return              number of the blocks, which results were recomputed
+ */
+size_t incremental_set(incremental_t *engine, size_t index, int altitude);
+
+#endif // INCREMENTAL_H
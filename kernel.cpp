@@ -0,0 +1,375 @@
+/**************************************************************
+ * File:		kernel.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The module of the exact slope kernels used by the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    kernel.cpp
+ * @brief   This module contains the implementation of the kernels working with
+ *          the exact slopes. Each kernel is vectorized with the AVX-512 or AVX2
+ *          instructions when they are available at the compile time, otherwise
+ *          it falls back to the scalar path, which serves as the reference.
+ */
+
+#include "kernel.h"
+
+#include <algorithm>
+#include <cassert>
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Scalar reference implementation of the kernel computing the slopes.
+ */
+template <typename altitude_t>
+static void compute_slopes_scalar(
+    const altitude_t *altitudes, int observer_altitude, size_t first_distance, size_t count, slope_t *slopes
+) {
+    // slope[i] = (altitude[i] - altitude[0]) / i; neutral item for i=0
+    for (size_t i = 0; i < count; i++) {
+        slopes[i] = (first_distance + i) ?
+                    slope_t{altitudes[i] - observer_altitude, int(first_distance + i)} : SLOPE_MIN;
+    }
+}
+
+/**
+ * Scalar reference implementation of the kernel reducing the slopes.
+ */
+static slope_t max_slope_scalar(const slope_t *slopes, size_t count, slope_t initial) {
+    // max = max(max, slope[i]) for each slope in the sequence
+    for (size_t i = 0; i < count; i++) {
+        initial = slope_max(initial, slopes[i]);
+    }
+    return initial;
+}
+
+/**
+ * Scalar reference implementation of the kernel comparing the slopes.
+ */
+static uint64_t compare_slopes_scalar(const slope_t *slopes, const slope_t *previous, size_t count) {
+    // if (slope[i] > max-previous-slope[i]) bit[i] = visible else not visible
+    uint64_t word = 0;
+    for (size_t i = 0; i < count; i++) {
+        word |= (uint64_t) slope_greater(slopes[i], previous[i]) << i;
+    }
+    return word;
+}
+
+#if defined(__AVX512F__)
+// Number of the slopes processed by the one vector instruction
+#define LANES 8
+// Vector register holding LANES slopes, each of them within the one 64-bit lane
+typedef __m512i vector_t;
+// Loads LANES slopes from the unaligned memory
+#define LOAD(p) _mm512_loadu_si512((const void *) (p))
+// Stores LANES slopes to the unaligned memory
+#define STORE(p, v) _mm512_storeu_si512((void *) (p), v)
+// Broadcasts the one slope to all lanes
+#define BROADCAST(s) _mm512_set1_epi64((long long) ((unsigned long long) (unsigned) (s).den << 32 | (unsigned) (s).num))
+// Swaps the numerator and the denominator within each lane
+#define SWAP(v) _mm512_shuffle_epi32(v, _MM_PERM_CDAB)
+// Multiplies the low signed 32-bit halves of the lanes to the 64-bit products
+#define MUL(a, b) _mm512_mul_epi32(a, b)
+// Extracts the denominators of the lanes as the 64-bit integers
+#define DEN(v) _mm512_srli_epi64(v, 32)
+// Mask of the lanes where the first operand is greater than the second one
+#define GT(a, b) _mm512_cmpgt_epi64_mask(a, b)
+// Mask of the lanes where the operands are equal
+#define EQ(a, b) _mm512_cmpeq_epi64_mask(a, b)
+// Takes the lanes of the second operand where the mask is set
+#define BLEND(m, a, b) _mm512_mask_blend_epi64(m, a, b)
+// The mask of the lanes is the integer with the one bit for each lane
+typedef __mmask8 mask_t;
+// Converts the mask of the lanes to the bits of the integer
+#define BITS(m) ((unsigned) (m))
+// Combination of the masks
+#define MASK_OR(a, b) ((mask_t) ((a) | (b)))
+#define MASK_AND(a, b) ((mask_t) ((a) & (b)))
+#elif defined(__AVX2__)
+// Number of the slopes processed by the one vector instruction
+#define LANES 4
+// Vector register holding LANES slopes, each of them within the one 64-bit lane
+typedef __m256i vector_t;
+// Loads LANES slopes from the unaligned memory
+#define LOAD(p) _mm256_loadu_si256((const __m256i *) (p))
+// Stores LANES slopes to the unaligned memory
+#define STORE(p, v) _mm256_storeu_si256((__m256i *) (p), v)
+// Broadcasts the one slope to all lanes
+#define BROADCAST(s) _mm256_set1_epi64x((long long) ((unsigned long long) (unsigned) (s).den << 32 | (unsigned) (s).num))
+// Swaps the numerator and the denominator within each lane
+#define SWAP(v) _mm256_shuffle_epi32(v, 0xB1)
+// Multiplies the low signed 32-bit halves of the lanes to the 64-bit products
+#define MUL(a, b) _mm256_mul_epi32(a, b)
+// Extracts the denominators of the lanes as the 64-bit integers
+#define DEN(v) _mm256_srli_epi64(v, 32)
+// Mask of the lanes where the first operand is greater than the second one
+#define GT(a, b) _mm256_cmpgt_epi64(a, b)
+// Mask of the lanes where the operands are equal
+#define EQ(a, b) _mm256_cmpeq_epi64(a, b)
+// Takes the lanes of the second operand where the mask is set
+#define BLEND(m, a, b) _mm256_blendv_epi8(a, b, m)
+// The mask of the lanes is the vector with all bits set within the selected lanes
+typedef __m256i mask_t;
+// Converts the mask of the lanes to the bits of the integer
+#define BITS(m) ((unsigned) _mm256_movemask_pd(_mm256_castsi256_pd(m)))
+// Combination of the masks
+#define MASK_OR(a, b) _mm256_or_si256(a, b)
+#define MASK_AND(a, b) _mm256_and_si256(a, b)
+#endif
+
+#if defined(__AVX512F__)
+/**
+ * Loads 8 altitudes as the 32-bit integers.
+ */
+static inline __m256i load_altitudes(const int *altitudes) {
+    return _mm256_loadu_si256((const __m256i *) altitudes);
+}
+
+/**
+ * Loads 8 altitudes stored as the 16-bit integers and extends them to the 32-bit integers.
+ */
+static inline __m256i load_altitudes(const int16_t *altitudes) {
+    return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) altitudes));
+}
+#elif defined(__AVX2__)
+/**
+ * Loads 4 altitudes as the 32-bit integers.
+ */
+static inline __m128i load_altitudes(const int *altitudes) {
+    return _mm_loadu_si128((const __m128i *) altitudes);
+}
+
+/**
+ * Loads 4 altitudes stored as the 16-bit integers and extends them to the 32-bit integers.
+ */
+static inline __m128i load_altitudes(const int16_t *altitudes) {
+    return _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *) altitudes));
+}
+#endif
+
+#ifdef LANES
+/**
+ * Vectorized version of the slope_max function working on all lanes at once.
+ */
+static inline vector_t vector_slope_max(vector_t a, vector_t b) {
+    // Compute both cross products of the fractions within each lane
+    vector_t left = MUL(a, SWAP(b)), right = MUL(b, SWAP(a));
+    // Select the second slope when it is steeper or it is equal and it has the smaller denominator
+    mask_t steeper = MASK_OR(GT(right, left), MASK_AND(EQ(right, left), GT(DEN(a), DEN(b))));
+    return BLEND(steeper, a, b);
+}
+#endif
+
+template <typename altitude_t>
+void compute_slopes(
+    const altitude_t *altitudes, int observer_altitude, size_t first_distance, size_t count, slope_t *slopes
+) {
+    // Index of the first altitude that has not been processed yet
+    size_t i = 0;
+    // The observer itself obtains the neutral item, thus it is processed by the scalar path
+    if (!first_distance && count) {
+        compute_slopes_scalar(altitudes, observer_altitude, first_distance, 1, slopes);
+        i = 1;
+    }
+#if defined(__AVX512F__)
+    // Broadcast the altitude of the observer and prepare the distances of the lanes relative to the first one
+    __m256i observer = _mm256_set1_epi32(observer_altitude), lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (; i + LANES <= count; i += LANES) {
+        // num[j] = altitude[i + j] - altitude[0]
+        __m256i num = _mm256_sub_epi32(load_altitudes(altitudes + i), observer);
+        // den[j] = first_distance + i + j
+        __m256i den = _mm256_add_epi32(_mm256_set1_epi32(int(first_distance + i)), lanes);
+        // Interleave the numerators and the denominators to the pairs (num, den) within 64-bit lanes
+        vector_t pairs = _mm512_or_si512(
+                _mm512_and_si512(_mm512_cvtepi32_epi64(num), _mm512_set1_epi64(0xFFFFFFFFLL)),
+                _mm512_slli_epi64(_mm512_cvtepu32_epi64(den), 32)
+        );
+        STORE(slopes + i, pairs);
+    }
+#elif defined(__AVX2__)
+    // Broadcast the altitude of the observer and prepare the distances of the lanes relative to the first one
+    __m128i observer = _mm_set1_epi32(observer_altitude), lanes = _mm_setr_epi32(0, 1, 2, 3);
+    for (; i + LANES <= count; i += LANES) {
+        // num[j] = altitude[i + j] - altitude[0]
+        __m128i num = _mm_sub_epi32(load_altitudes(altitudes + i), observer);
+        // den[j] = first_distance + i + j
+        __m128i den = _mm_add_epi32(_mm_set1_epi32(int(first_distance + i)), lanes);
+        // Interleave the numerators and the denominators to the pairs (num, den) within 64-bit lanes
+        vector_t pairs = _mm256_or_si256(
+                _mm256_and_si256(_mm256_cvtepi32_epi64(num), _mm256_set1_epi64x(0xFFFFFFFFLL)),
+                _mm256_slli_epi64(_mm256_cvtepu32_epi64(den), 32)
+        );
+        STORE(slopes + i, pairs);
+    }
+#endif
+    // Process the remaining altitudes by the scalar path
+    compute_slopes_scalar(altitudes + i, observer_altitude, first_distance + i, count - i, slopes + i);
+
+#ifdef VERIFY_KERNEL
+    // Check the whole output against the scalar reference implementation
+    for (size_t j = 0; j < count; j++) {
+        slope_t reference;
+        compute_slopes_scalar(altitudes + j, observer_altitude, first_distance + j, 1, &reference);
+        assert(slopes[j].num == reference.num && slopes[j].den == reference.den);
+    }
+#endif
+}
+
+slope_t max_slope(const slope_t *slopes, size_t count, slope_t initial) {
+    // Index of the first slope that has not been processed yet
+    size_t i = 0;
+    // The found maximum, which is the initial one when the sequence is empty
+    slope_t maximum = initial;
+#ifdef LANES
+    if (count >= LANES) {
+        // Each lane of the accumulator holds the maximum of the slopes with the same lane index
+        vector_t accumulator = BROADCAST(initial);
+        for (; i + LANES <= count; i += LANES) {
+            accumulator = vector_slope_max(accumulator, LOAD(slopes + i));
+        }
+        // Reduce the lanes of the accumulator; the order does not matter since slope_max is the total order
+        slope_t lanes[LANES];
+        STORE(lanes, accumulator);
+        maximum = max_slope_scalar(lanes, LANES, initial);
+    }
+#endif
+    // Process the remaining slopes by the scalar path
+    maximum = max_slope_scalar(slopes + i, count - i, maximum);
+
+#ifdef VERIFY_KERNEL
+    // Check the found maximum against the scalar reference implementation
+    slope_t reference = max_slope_scalar(slopes, count, initial);
+    assert(maximum.num == reference.num && maximum.den == reference.den);
+#endif
+    return maximum;
+}
+
+void compare_slopes(const slope_t *slopes, const slope_t *previous, size_t count, uint64_t *result) {
+    // Each word of the bitset is composed from WORD_BITS results and it is stored at once
+    for (size_t first = 0; first < count; first += WORD_BITS) {
+        size_t block = std::min((size_t) WORD_BITS, count - first);
+        // Index of the first slope of the word that has not been processed yet
+        size_t i = 0;
+        uint64_t word = 0;
+#ifdef LANES
+        for (; i + LANES <= block; i += LANES) {
+            // Load the slopes of the points and the relevant maximums of the previous slopes
+            vector_t current = LOAD(slopes + first + i), maximum = LOAD(previous + first + i);
+            // slope[i] > max-previous-slope[i] <=> slope[i].num * max[i].den > max[i].num * slope[i].den
+            word |= (uint64_t) BITS(GT(MUL(current, SWAP(maximum)), MUL(maximum, SWAP(current)))) << i;
+        }
+#endif
+        // Process the remaining slopes of the word by the scalar path
+        word |= compare_slopes_scalar(slopes + first + i, previous + first + i, block - i) << i;
+        result[first / WORD_BITS] = word;
+
+#ifdef VERIFY_KERNEL
+        // Check the whole word against the scalar reference implementation
+        assert(word == compare_slopes_scalar(slopes + first, previous + first, block));
+#endif
+    }
+}
+
+template <typename altitude_t>
+slope_t max_altitude_slope(
+    const altitude_t *altitudes, int observer_altitude, size_t first_distance, size_t count, slope_t initial
+) {
+    // Block of the computed slopes, which is reused by all blocks of the sequence
+    slope_t slopes[SWEEP_BLOCK];
+    for (size_t i = 0; i < count; i += SWEEP_BLOCK) {
+        size_t block = std::min((size_t) SWEEP_BLOCK, count - i);
+        // max = max(max, (altitude[i] - altitude[0]) / i) for each altitude in the block
+        compute_slopes(altitudes + i, observer_altitude, first_distance + i, block, slopes);
+        initial = max_slope(slopes, block, initial);
+    }
+    return initial;
+}
+
+template <typename altitude_t>
+slope_t sweep_slopes(
+    const altitude_t *altitudes, int observer_altitude, size_t first_distance, size_t count, slope_t running,
+    uint64_t *result, size_t first_bit
+) {
+    // Block of the computed slopes, which is reused by all blocks of the sequence
+    slope_t slopes[SWEEP_BLOCK];
+    for (size_t i = 0; i < count; i += SWEEP_BLOCK) {
+        size_t block = std::min((size_t) SWEEP_BLOCK, count - i);
+        compute_slopes(altitudes + i, observer_altitude, first_distance + i, block, slopes);
+        // if (slope[i] > max-previous-slope) bit[i] = visible else not visible; max = max(max, slope[i])
+        for (size_t j = 0; j < block;) {
+            // Index of the bit within the bitset and the number of the results within the same word
+            size_t bit = first_bit + i + j, part = std::min(WORD_BITS - bit % WORD_BITS, block - j);
+            uint64_t word = 0;
+            for (size_t k = 0; k < part; k++, j++) {
+                word |= (uint64_t) slope_greater(slopes[j], running) << k;
+                running = slope_max(running, slopes[j]);
+            }
+            result[bit / WORD_BITS] |= word << (bit % WORD_BITS);
+        }
+    }
+    return running;
+}
+
+template <typename altitude_t>
+slope_t max_altitude_slope_backward(
+    const altitude_t *altitudes, int observer_altitude, size_t last_distance, size_t count, slope_t initial
+) {
+    // max = max(max, (altitude[i] - altitude[o]) / (o - i)) for each altitude in the sequence
+    for (size_t i = 0; i < count; i++) {
+        initial = slope_max(initial, slope_t{altitudes[i] - observer_altitude, int(last_distance + count - 1 - i)});
+    }
+    return initial;
+}
+
+template <typename altitude_t>
+slope_t sweep_slopes_backward(
+    const altitude_t *altitudes, int observer_altitude, size_t last_distance, size_t count, slope_t running,
+    uint64_t *result, size_t first_bit
+) {
+    // The altitudes are swept from the nearest to the observer, i.e. from the last one
+    for (size_t i = count; i-- > 0;) {
+        slope_t slope = {altitudes[i] - observer_altitude, int(last_distance + count - 1 - i)};
+        // if (slope[i] > max-following-slope) bit[i] = visible else not visible; max = max(max, slope[i])
+        size_t bit = first_bit + i;
+        result[bit / WORD_BITS] |= (uint64_t) slope_greater(slope, running) << (bit % WORD_BITS);
+        running = slope_max(running, slope);
+    }
+    return running;
+}
+
+wide_slope_t sweep_slopes_wide(
+    const int *altitudes, int observer_altitude, uint64_t first_distance, size_t count, wide_slope_t running,
+    uint64_t *result, size_t first_bit
+) {
+    for (size_t i = 0; i < count; i++) {
+        // slope[i] = (altitude[i] - altitude[0]) / i; neutral item for i=0
+        wide_slope_t slope = (first_distance + i) ?
+                wide_slope_t{(long long) altitudes[i] - observer_altitude, (long long) (first_distance + i)} :
+                WIDE_SLOPE_MIN;
+        // if (slope[i] > max-previous-slope) bit[i] = visible else not visible; max = max(max, slope[i])
+        size_t bit = first_bit + i;
+        result[bit / WORD_BITS] |= (uint64_t) wide_slope_greater(slope, running) << (bit % WORD_BITS);
+        running = wide_slope_max(running, slope);
+    }
+    return running;
+}
+
+// Instantiates the kernels reading the altitudes for the given type of the stored altitudes
+#define INSTANTIATE_KERNELS(altitude_t) \
+    template void compute_slopes(const altitude_t *, int, size_t, size_t, slope_t *); \
+    template slope_t max_altitude_slope(const altitude_t *, int, size_t, size_t, slope_t); \
+    template slope_t sweep_slopes(const altitude_t *, int, size_t, size_t, slope_t, uint64_t *, size_t); \
+    template slope_t max_altitude_slope_backward(const altitude_t *, int, size_t, size_t, slope_t); \
+    template slope_t sweep_slopes_backward(const altitude_t *, int, size_t, size_t, slope_t, uint64_t *, size_t);
+
+INSTANTIATE_KERNELS(int16_t)
+INSTANTIATE_KERNELS(int)
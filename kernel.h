@@ -0,0 +1,254 @@
+/**************************************************************
+ * File:		kernel.h
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The header module of the exact slope kernels used by the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    kernel.h
+ * @brief   The header module contains the definition of the exact slope type
+ *          and the declarations of the vectorized kernels working with them.
+ *          The angle arctan((x_i - x_0) / i) is monotonic in its argument, so
+ *          the kernels compare the slopes (x_i - x_0) / i directly as integer
+ *          fractions by the cross-multiplication, without any rounding. The kernels
+ *          reading the altitudes are templated on the type of the stored altitudes,
+ *          they are instantiated for the 16-bit (int16_t) and the 32-bit (int) ones.
+ *          The narrower altitudes halve the read memory, the slopes are the same.
+ */
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Flag for verifying the vectorized kernels against the scalar reference implementation
+//#define VERIFY_KERNEL
+// Size of the slope variable to use as the size of the elements within the shared memory
+#define SLOPE_UNIT sizeof(slope_t)
+// Number of the results packed to the one word of the bitset (bit i of the word is the result of the point i)
+#define WORD_BITS 64
+// Number of the slopes computed at once by the fused kernels, the block of the slopes stays in the L1 cache
+#define SWEEP_BLOCK 512 // multiple of WORD_BITS
+// Define the minimum of the slopes to use as the neutral element (I) within max-prescan operation
+#define SLOPE_MIN slope_t{-1, 0}
+// Define the minimum of the wide slopes (the neutral element of their maximum)
+#define WIDE_SLOPE_MIN wide_slope_t{-1, 0}
+
+/**
+ * The slope (x_i - x_0) / i represented as the exact integer fraction. The numerator
+ * is the difference of the altitudes and the denominator is the distance from the
+ * observer. The altitudes are signed integers; while their magnitudes stay below 2^30,
+ * their differences fit to the int and the cross products of the numerators with the
+ * denominators always fit to the 64-bit integer. The denominator is positive for
+ * all points except the neutral element (SLOPE_MIN), which is -1 / 0.
+ */
+typedef struct slope {
+    // The difference of the altitude of the point and the altitude of the observer
+    int num;
+    // The distance of the point from the observer
+    int den;
+} slope_t;
+
+/**
+ * The slope with the 64-bit numerator and denominator used for the distances, which do
+ * not fit to the int. Their cross products are computed by the 128-bit integers.
+ */
+typedef struct wide_slope {
+    // The difference of the altitude of the point and the altitude of the observer
+    long long num;
+    // The distance of the point from the observer
+    long long den;
+} wide_slope_t;
+
+/**
+ * Compares two slopes by the cross-multiplication of their fractions.
+ *
+ * @param a     first compared slope
+ * @param b     second compared slope
+ * @return      true when the slope a is strictly steeper than the slope b, otherwise false
+ */
+inline bool slope_greater(slope_t a, slope_t b) {
+    // a.num / a.den > b.num / b.den <=> a.num * b.den > b.num * a.den; both denominators are non-negative
+    return (long long) a.num * b.den > (long long) b.num * a.den;
+}
+
+/**
+ * Selects the steeper from two slopes. The equal slopes are broken by the smaller
+ * denominator, so the maximum does not depend on the order of the operands and the
+ * vectorized reductions give the bit-identical results as the scalar ones.
+ *
+ * @param a     first compared slope
+ * @param b     second compared slope
+ * @return      the steeper slope from the given slopes
+ */
+inline slope_t slope_max(slope_t a, slope_t b) {
+    // Compute both cross products of the given fractions
+    long long left = (long long) a.num * b.den, right = (long long) b.num * a.den;
+    // Select the second slope when it is steeper or it is equal and it has the smaller denominator
+    return (right > left || (right == left && b.den < a.den)) ? b : a;
+}
+
+/**
+ * Compares two wide slopes by the cross-multiplication of their fractions.
+ *
+ * @param a     first compared slope
+ * @param b     second compared slope
+ * @return      true when the slope a is strictly steeper than the slope b, otherwise false
+ */
+inline bool wide_slope_greater(wide_slope_t a, wide_slope_t b) {
+    return (__int128) a.num * b.den > (__int128) b.num * a.den;
+}
+
+/**
+ * Selects the steeper from two wide slopes, the equal slopes are broken by the smaller
+ * denominator as by the slope_max.
+ *
+ * @param a     first compared slope
+ * @param b     second compared slope
+ * @return      the steeper slope from the given slopes
+ */
+inline wide_slope_t wide_slope_max(wide_slope_t a, wide_slope_t b) {
+    __int128 left = (__int128) a.num * b.den, right = (__int128) b.num * a.den;
+    return (right > left || (right == left && b.den < a.den)) ? b : a;
+}
+
+/**
+ * Computes the slopes of the given sequence of the altitudes with respect to the
+ * altitude of the observer. The point with the zero distance (the observer itself)
+ * obtains the neutral element SLOPE_MIN.
+ *
+ * @param altitudes             sequence of the altitudes to compute the slopes from
+ * @param observer_altitude     altitude of the observer
+ * @param first_distance        distance of the first altitude from the observer
+ * @param count                 number of the altitudes in the sequence
+ * @param slopes                output sequence of the computed slopes
+ */
+template <typename altitude_t>
+void compute_slopes(
+    const altitude_t *altitudes, int observer_altitude, size_t first_distance, size_t count, slope_t *slopes
+);
+
+/**
+ * Finds the steepest slope within the given sequence of the slopes.
+ *
+ * @param slopes    sequence of the slopes to reduce
+ * @param count     number of the slopes in the sequence
+ * @param initial   initial value of the maximum (SLOPE_MIN for the whole reduction)
+ * @return          the steepest slope from the initial one and the given sequence
+ */
+slope_t max_slope(const slope_t *slopes, size_t count, slope_t initial);
+
+/**
+ * Compares each slope with the relevant maximum of the previous slopes and
+ * stores whether it is strictly steeper (the point is visible). The results are
+ * packed to the bitset, whole words are written (the unused bits are zero).
+ *
+ * @param slopes    sequence of the slopes of the points
+ * @param previous  sequence of the maximum previous slopes (result of the max-prescan)
+ * @param count     number of the points in the sequences
+ * @param result    output bitset of the visibilities of the points
+ */
+void compare_slopes(const slope_t *slopes, const slope_t *previous, size_t count, uint64_t *result);
+
+/**
+ * Finds the steepest slope of the given sequence of the altitudes without storing
+ * the slopes. The slopes are computed by the blocks of SWEEP_BLOCK slopes, each of
+ * them is reduced while it is still in the cache.
+ *
+ * @param altitudes             sequence of the altitudes to compute the slopes from
+ * @param observer_altitude     altitude of the observer
+ * @param first_distance        distance of the first altitude from the observer
+ * @param count                 number of the altitudes in the sequence
+ * @param initial               initial value of the maximum (SLOPE_MIN for the whole reduction)
+ * @return                      the steepest slope from the initial one and the slopes of the altitudes
+ */
+template <typename altitude_t>
+slope_t max_altitude_slope(
+    const altitude_t *altitudes, int observer_altitude, size_t first_distance, size_t count, slope_t initial
+);
+
+/**
+ * Computes the slopes of the given sequence of the altitudes, their running maximum
+ * and the visibilities of the points in the one sweep. The slopes are computed by the
+ * blocks of SWEEP_BLOCK slopes, thus neither the slopes nor the maximum previous slopes
+ * are stored for the whole sequence. The visibility of the altitude j is combined (OR)
+ * to the bit (first_bit + j) of the bitset, thus the bits have to be zero before.
+ *
+ * @param altitudes             sequence of the altitudes to compute the slopes from
+ * @param observer_altitude     altitude of the observer
+ * @param first_distance        distance of the first altitude from the observer
+ * @param count                 number of the altitudes in the sequence
+ * @param running               maximum of all slopes preceding the sequence
+ * @param result                output bitset of the visibilities of the points
+ * @param first_bit             index of the bit of the first altitude within the bitset
+ * @return                      maximum of all slopes up to the end of the sequence
+ */
+template <typename altitude_t>
+slope_t sweep_slopes(
+    const altitude_t *altitudes, int observer_altitude, size_t first_distance, size_t count, slope_t running,
+    uint64_t *result, size_t first_bit
+);
+
+/**
+ * Finds the steepest slope of the given sequence of the altitudes placed before the
+ * observer, thus the distance decreases along the sequence down to the given one.
+ *
+ * @param altitudes             sequence of the altitudes to compute the slopes from
+ * @param observer_altitude     altitude of the observer
+ * @param last_distance         distance of the last altitude from the observer
+ * @param count                 number of the altitudes in the sequence
+ * @param initial               initial value of the maximum (SLOPE_MIN for the whole reduction)
+ * @return                      the steepest slope from the initial one and the slopes of the altitudes
+ */
+template <typename altitude_t>
+slope_t max_altitude_slope_backward(
+    const altitude_t *altitudes, int observer_altitude, size_t last_distance, size_t count, slope_t initial
+);
+
+/**
+ * The backward version of the sweep_slopes kernel for the altitudes placed before the
+ * observer. The sequence is swept from its last altitude (the nearest to the observer)
+ * to the first one, thus the running maximum is the reverse max-scan of the slopes.
+ *
+ * @param altitudes             sequence of the altitudes to compute the slopes from
+ * @param observer_altitude     altitude of the observer
+ * @param last_distance         distance of the last altitude from the observer
+ * @param count                 number of the altitudes in the sequence
+ * @param running               maximum of all slopes between the sequence and the observer
+ * @param result                output bitset of the visibilities of the points
+ * @param first_bit             index of the bit of the first altitude within the bitset
+ * @return                      maximum of all slopes from the first altitude up to the observer
+ */
+template <typename altitude_t>
+slope_t sweep_slopes_backward(
+    const altitude_t *altitudes, int observer_altitude, size_t last_distance, size_t count, slope_t running,
+    uint64_t *result, size_t first_bit
+);
+
+/**
+ * The version of the sweep_slopes kernel with the wide slopes for the sequences, which
+ * distances from the observer do not fit to the int.
+ *
+ * @param altitudes             sequence of the altitudes to compute the slopes from
+ * @param observer_altitude     altitude of the observer
+ * @param first_distance        distance of the first altitude from the observer
+ * @param count                 number of the altitudes in the sequence
+ * @param running               maximum of all slopes preceding the sequence
+ * @param result                output bitset of the visibilities of the points
+ * @param first_bit             index of the bit of the first altitude within the bitset
+ * @return                      maximum of all slopes up to the end of the sequence
+ */
+wide_slope_t sweep_slopes_wide(
+    const int *altitudes, int observer_altitude, uint64_t first_distance, size_t count, wide_slope_t running,
+    uint64_t *result, size_t first_bit
+);
+
+#endif // KERNEL_H
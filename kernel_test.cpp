@@ -0,0 +1,236 @@
+/**************************************************************
+ * File:		kernel_test.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The test of the exact slope kernels used by the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    kernel_test.cpp
+ * @brief   This module compares the outputs of all exact slope kernels bit for bit
+ *          with the straightforward scalar reference written here, independently
+ *          of the kernels. The altitudes are random, also negative ones, stored in
+ *          both supported types; the counts and the offsets of the bits are chosen
+ *          to exercise the vector bodies as well as the scalar remainders. The test
+ *          is built by vid_test.py with and without the VERIFY_KERNEL flag and for
+ *          all available instruction sets, it prints the failed checks and returns
+ *          the number of them.
+ */
+
+#include "kernel.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Number of the random sequences tested by each kernel
+#define TEST_ROUNDS 200
+// Maximum number of the altitudes within the tested sequence (more than one SWEEP_BLOCK)
+#define TEST_COUNT 1300
+// Maximum offset of the first bit of the results within the bitset
+#define TEST_BIT_OFFSET 130
+// Number of the words of the bitset holding the given number of the results
+#define TEST_WORDS(count) (((count) + WORD_BITS - 1) / WORD_BITS)
+
+// Generator of the random numbers, seeded by the fixed value for the reproducible failures
+static std::mt19937_64 generator(20261017);
+// Number of the failed checks
+static int failures = 0;
+
+/**
+ * Returns the random integer from the closed interval [low, high].
+ */
+static long long random_between(long long low, long long high) {
+    return std::uniform_int_distribution<long long>(low, high)(generator);
+}
+
+/**
+ * Reports the failed check of the kernel within the given round.
+ */
+static void check(bool condition, const char *kernel, const char *type, int round) {
+    if (!condition) {
+        fprintf(stderr, "FAIL: %s<%s> round %d\n", kernel, type, round);
+        failures++;
+    }
+}
+
+/**
+ * Reference comparison of the exact fractions num / den; the neutral element -1 / 0 is below all other slopes.
+ */
+static bool reference_greater(long long a_num, long long a_den, long long b_num, long long b_den) {
+    if (!a_den || !b_den) {
+        return !b_den && a_den;
+    }
+    return (__int128) a_num * b_den > (__int128) b_num * a_den;
+}
+
+/**
+ * Reference maximum of two slopes, the equal ones are broken by the smaller denominator.
+ */
+template <typename fraction_t>
+static fraction_t reference_max(fraction_t a, fraction_t b) {
+    if (reference_greater(b.num, b.den, a.num, a.den)) {
+        return b;
+    }
+    if (reference_greater(a.num, a.den, b.num, b.den)) {
+        return a;
+    }
+    return (b.den < a.den) ? b : a;
+}
+
+/**
+ * Reference slope of the altitude in the given distance from the observer.
+ */
+static slope_t reference_slope(long long altitude, int observer_altitude, long long distance) {
+    return distance ? slope_t{int(altitude - observer_altitude), int(distance)} : SLOPE_MIN;
+}
+
+/**
+ * Returns the bit of the given index within the bitset.
+ */
+static bool bit_of(const std::vector<uint64_t> &bits, size_t index) {
+    return (bits[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+/**
+ * Generates the random altitudes of the given type, the narrow range produces many equal slopes.
+ */
+template <typename altitude_t>
+static std::vector<altitude_t> random_altitudes(size_t count, long long range) {
+    std::vector<altitude_t> altitudes(count);
+    for (auto &altitude : altitudes) {
+        altitude = (altitude_t) random_between(-range, range);
+    }
+    return altitudes;
+}
+
+/**
+ * Tests the kernels reading the altitudes of the given type.
+ */
+template <typename altitude_t>
+static void test_altitude_kernels(const char *type, long long max_altitude) {
+    for (int round = 0; round < TEST_ROUNDS; round++) {
+        // Every other round uses the narrow range of the altitudes, thus many slopes are equal
+        long long range = (round % 2) ? 50 : max_altitude;
+        size_t count = random_between(0, TEST_COUNT);
+        std::vector<altitude_t> altitudes = random_altitudes<altitude_t>(count, range);
+        int observer_altitude = (int) random_between(-range, range);
+        // The distance zero places the observer itself to the first altitude
+        size_t distance = (round % 3) ? random_between(1, 1 << 20) : 0;
+        size_t first_bit = random_between(0, TEST_BIT_OFFSET);
+        slope_t initial = (round % 5) ? reference_slope(random_between(-range, range), observer_altitude,
+                                                        random_between(1, 1000)) : SLOPE_MIN;
+
+        // Reference slopes, their running maximums and the visibilities of the forward sweep
+        std::vector<slope_t> slopes(count), previous(count);
+        std::vector<uint64_t> visible(TEST_WORDS(first_bit + count) + 1, 0);
+        slope_t running = initial, maximum = initial;
+        for (size_t i = 0; i < count; i++) {
+            slopes[i] = reference_slope(altitudes[i], observer_altitude, distance + i);
+            previous[i] = running;
+            if (reference_greater(slopes[i].num, slopes[i].den, running.num, running.den)) {
+                visible[(first_bit + i) / WORD_BITS] |= 1ULL << ((first_bit + i) % WORD_BITS);
+            }
+            running = reference_max(running, slopes[i]);
+            maximum = reference_max(maximum, slopes[i]);
+        }
+
+        // compute_slopes
+        std::vector<slope_t> computed(count);
+        compute_slopes(altitudes.data(), observer_altitude, distance, count, computed.data());
+        bool same = true;
+        for (size_t i = 0; i < count; i++) {
+            same &= computed[i].num == slopes[i].num && computed[i].den == slopes[i].den;
+        }
+        check(same, "compute_slopes", type, round);
+
+        // max_slope and max_altitude_slope
+        slope_t found = max_slope(slopes.data(), count, initial);
+        check(found.num == maximum.num && found.den == maximum.den, "max_slope", type, round);
+        found = max_altitude_slope(altitudes.data(), observer_altitude, distance, count, initial);
+        check(found.num == maximum.num && found.den == maximum.den, "max_altitude_slope", type, round);
+
+        // compare_slopes starts at the first bit of the bitset
+        std::vector<uint64_t> compared(TEST_WORDS(count) + 1, 0);
+        compare_slopes(slopes.data(), previous.data(), count, compared.data());
+        same = true;
+        for (size_t i = 0; i < count; i++) {
+            same &= bit_of(compared, i) == bit_of(visible, first_bit + i);
+        }
+        check(same, "compare_slopes", type, round);
+
+        // sweep_slopes combines the results to the zeroed bitset from the given bit
+        std::vector<uint64_t> swept(visible.size(), 0);
+        found = sweep_slopes(altitudes.data(), observer_altitude, distance, count, initial, swept.data(), first_bit);
+        check(found.num == running.num && found.den == running.den && swept == visible, "sweep_slopes", type, round);
+
+        // The backward kernels sweep the same altitudes from the last one at the nearest distance
+        size_t last_distance = random_between(1, 1 << 20);
+        std::vector<uint64_t> backward_visible(visible.size(), 0);
+        running = initial;
+        maximum = initial;
+        for (size_t i = count; i-- > 0;) {
+            slope_t slope = reference_slope(altitudes[i], observer_altitude, last_distance + count - 1 - i);
+            if (reference_greater(slope.num, slope.den, running.num, running.den)) {
+                backward_visible[(first_bit + i) / WORD_BITS] |= 1ULL << ((first_bit + i) % WORD_BITS);
+            }
+            running = reference_max(running, slope);
+            maximum = reference_max(maximum, slope);
+        }
+        found = max_altitude_slope_backward(altitudes.data(), observer_altitude, last_distance, count, initial);
+        check(found.num == maximum.num && found.den == maximum.den, "max_altitude_slope_backward", type, round);
+        std::vector<uint64_t> backward_swept(visible.size(), 0);
+        found = sweep_slopes_backward(
+                altitudes.data(), observer_altitude, last_distance, count, initial, backward_swept.data(), first_bit
+        );
+        check(found.num == running.num && found.den == running.den && backward_swept == backward_visible,
+              "sweep_slopes_backward", type, round);
+    }
+}
+
+/**
+ * Tests the kernel with the wide slopes, the distances exceed the range of the int.
+ */
+static void test_wide_kernel() {
+    for (int round = 0; round < TEST_ROUNDS; round++) {
+        long long range = (round % 2) ? 50 : (1 << 30) - 1;
+        size_t count = random_between(0, TEST_COUNT);
+        std::vector<int> altitudes = random_altitudes<int>(count, range);
+        int observer_altitude = (int) random_between(-range, range);
+        uint64_t distance = (round % 3) ? random_between(1LL << 31, 1LL << 40) : 0;
+        size_t first_bit = random_between(0, TEST_BIT_OFFSET);
+
+        std::vector<uint64_t> visible(TEST_WORDS(first_bit + count) + 1, 0);
+        wide_slope_t running = WIDE_SLOPE_MIN;
+        for (size_t i = 0; i < count; i++) {
+            wide_slope_t slope = (distance + i) ?
+                    wide_slope_t{(long long) altitudes[i] - observer_altitude, (long long) (distance + i)} :
+                    WIDE_SLOPE_MIN;
+            if (reference_greater(slope.num, slope.den, running.num, running.den)) {
+                visible[(first_bit + i) / WORD_BITS] |= 1ULL << ((first_bit + i) % WORD_BITS);
+            }
+            running = reference_max(running, slope);
+        }
+        std::vector<uint64_t> swept(visible.size(), 0);
+        wide_slope_t found = sweep_slopes_wide(
+                altitudes.data(), observer_altitude, distance, count, WIDE_SLOPE_MIN, swept.data(), first_bit
+        );
+        check(found.num == running.num && found.den == running.den && swept == visible, "sweep_slopes_wide", "int",
+              round);
+    }
+}
+
+int main() {
+    // The differences of the 32-bit altitudes have to fit to the int, the 16-bit ones use their whole range
+    test_altitude_kernels<int>("int", (1 << 30) - 1);
+    test_altitude_kernels<int16_t>("int16_t", INT16_MAX);
+    test_wide_kernel();
+    printf("%d failed checks\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+/**************************************************************
+ * File:		output.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The module of the output writers used by the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    output.cpp
+ * @brief   This module contains the implementation of the writers of the final
+ *          results in the text, raw and run-length encoded formats.
+ */
+
+#include "output.h"
+
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+/**
+ * Finds the end of the interval of the points with the same result as the given one.
+ * The whole words with the same results are skipped at once.
+ */
+static size_t interval_end(const uint64_t *result, size_t index, size_t total) {
+    // All bits of the words within the interval are equal to the result of the first point
+    uint64_t same = result_bit(result, index) ? ~0ULL : 0ULL;
+    while (index < total) {
+        // Bits of the word differing from the result of the interval, starting from the current point
+        uint64_t differ = (result[index / WORD_BITS] ^ same) >> (index % WORD_BITS);
+        if (differ) {
+            return std::min(total, index + __builtin_ctzll(differ));
+        }
+        // Move to the begin of the next word
+        index += WORD_BITS - index % WORD_BITS;
+    }
+    return total;
+}
+
+bool write_text(FILE *file, const uint64_t *result, size_t total, size_t observer) {
+    return write_text_range(file, result, 0, total, total, observer);
+}
+
+bool write_text_range(FILE *file, const uint64_t *result, size_t first, size_t count, size_t total, size_t observer) {
+    // Buffer of the formatted output, each point occupies two characters
+    std::vector<char> buffer(OUTPUT_BUFFER);
+    size_t length = 0;
+    bool written = true;
+    // The only altitude is written out also with its result after the place of the observation
+    if (total == 1) {
+        buffer[length++] = '_';
+        buffer[length++] = ',';
+    }
+    // Write out the result for each origina altitude
+    for (size_t i = first; i < first + count; i++) {
+        // Write out the place of the observation or the result in the specified format - visible (v) or unvisible (u)
+        buffer[length++] = (i == observer && total > 1) ? '_' : (result_bit(result, i - first) ? 'v' : 'u');
+        // Each result is followed by the delimiter, the last one by the new line
+        buffer[length++] = (i + 1 < total) ? ',' : '\n';
+        // Write out the full buffer at once
+        if (length == OUTPUT_BUFFER) {
+            written &= fwrite(buffer.data(), 1, length, file) == length;
+            length = 0;
+        }
+    }
+    // Write out the rest of the buffer
+    written &= fwrite(buffer.data(), 1, length, file) == length;
+    return (fflush(file) == 0) && written;
+}
+
+bool write_raw(FILE *file, const uint64_t *result, size_t total) {
+    // The words of the bitset are written directly without any formatting
+    size_t words = (total + WORD_BITS - 1) / WORD_BITS;
+    bool written = fwrite(result, sizeof(uint64_t), words, file) == words;
+    return (fflush(file) == 0) && written;
+}
+
+bool write_rle(FILE *file, const uint64_t *result, size_t total, size_t observer) {
+    // Buffer of the formatted output, the buffer is written out before it can overflow by the next interval
+    std::vector<char> buffer(OUTPUT_BUFFER);
+    size_t length = 0;
+    bool written = true;
+    // The only altitude is written out also with its result after the place of the observation
+    if (total == 1) {
+        length += snprintf(buffer.data(), OUTPUT_BUFFER, "_,1%c\n", result_bit(result, 0) ? 'v' : 'u');
+    }
+    // Write out the intervals of the same results, the observer ends the interval before it
+    for (size_t i = 0, end; total > 1 && i < total; i = end) {
+        const char *delimiter = i ? "," : "";
+        if (i == observer) {
+            // Write out the place of the observation
+            end = i + 1;
+            length += snprintf(buffer.data() + length, OUTPUT_BUFFER - length, "%s_", delimiter);
+        } else {
+            end = interval_end(result, i, (i < observer) ? observer : total);
+            length += snprintf(
+                    buffer.data() + length, OUTPUT_BUFFER - length, "%s%zu%c", delimiter, end - i,
+                    result_bit(result, i) ? 'v' : 'u'
+            );
+        }
+        // Write out the buffer, when the next interval may not fit to it
+        if (length + 32 > OUTPUT_BUFFER) {
+            written &= fwrite(buffer.data(), 1, length, file) == length;
+            length = 0;
+        }
+        // The last interval is followed by the new line
+        if (end == total) {
+            buffer[length++] = '\n';
+        }
+    }
+    // Write out the rest of the buffer
+    written &= fwrite(buffer.data(), 1, length, file) == length;
+    return (fflush(file) == 0) && written;
+}
+
+void append_intervals(const uint64_t *result, size_t first, size_t count, std::vector<long long> *intervals) {
+    // Each interval of the same results is either visible or not visible, only the visible ones are appended
+    for (size_t i = 0, end; i < count; i = end) {
+        end = interval_end(result, i, count);
+        if (result_bit(result, i)) {
+            intervals->push_back(first + i);
+            intervals->push_back(first + end - 1);
+        }
+    }
+}
+
+bool write_raster(FILE *file, const uint64_t *result, size_t width, size_t height, bool binary) {
+    // Header of the raster with its format and its dimensions
+    bool written = fprintf(file, "%s\n%zu %zu\n", binary ? "P4" : "P1", width, height) > 0;
+    // Buffer of one row, the plain row has one character per cell and the binary one one bit per cell
+    size_t row_length = binary ? (width + CHAR_BIT - 1) / CHAR_BIT : width + 1;
+    std::vector<unsigned char> row(row_length);
+    for (size_t y = 0; y < height; y++) {
+        std::fill(row.begin(), row.end(), binary ? 0 : '\n');
+        for (size_t x = 0; x < width; x++) {
+            bool visible = result_bit(result, y * width + x);
+            if (binary) {
+                row[x / CHAR_BIT] |= visible << (CHAR_BIT - 1 - x % CHAR_BIT);
+            } else {
+                row[x] = visible ? '1' : '0';
+            }
+        }
+        written &= fwrite(row.data(), 1, row_length, file) == row_length;
+    }
+    return (fflush(file) == 0) && written;
+}
@@ -0,0 +1,131 @@
+/**************************************************************
+ * File:		output.h
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The header module of the output writers used by the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    output.h
+ * @brief   The header module contains the declarations of the writers of the final
+ *          results. The results are stored as the bitset, where the bit i of the word
+ *          i / WORD_BITS is the visibility of the point i. The writers format the
+ *          results to the large buffer, which is written at once.
+ */
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "kernel.h"
+
+// Results written out as the text in the format _,v,u,...,v (the underscore is the observer)
+#define OUTPUT_TEXT 0
+// Results written out as the raw bitset (the words in the byte order of the machine)
+#define OUTPUT_RAW 1
+// Results written out as the run-length encoded intervals in the format _,3v,2u,...
+#define OUTPUT_RLE 2
+// Size of the buffer of the formatted output in bytes
+#define OUTPUT_BUFFER (1 << 20)
+
+/**
+ * Returns the result of the given point from the bitset.
+ *
+ * @param result    bitset of the visibilities of the points
+ * @param index     index of the point
+ * @return          true when the point is visible, otherwise false
+ */
+inline bool result_bit(const uint64_t *result, size_t index) {
+    return (result[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+/**
+ * Writes out the results in the text format v,u,_,...,v followed by the new line,
+ * where the observer is written out as the underscore.
+ *
+ * @param file      output file (e.g. the standard output)
+ * @param result    bitset of the visibilities of all points
+ * @param total     number of all points
+ * @param observer  index of the point, where the observer is placed
+ * @return          true when the results were written, otherwise false
+ */
+bool write_text(FILE *file, const uint64_t *result, size_t total, size_t observer);
+
+/**
+ * Writes out the results of the given range of the points in the text format, thus
+ * the consecutive ranges form together the output of the write_text. The last point
+ * of all points is followed by the new line.
+ *
+ * @param file      output file (e.g. the standard output)
+ * @param result    bitset of the visibilities of the range (bit 0 is the first point of the range)
+ * @param first     index of the first point of the range
+ * @param count     number of the points of the range
+ * @param total     number of all points
+ * @param observer  index of the point, where the observer is placed
+ * @return          true when the results were written, otherwise false
+ */
+bool write_text_range(FILE *file, const uint64_t *result, size_t first, size_t count, size_t total, size_t observer);
+
+/**
+ * Writes out the words of the bitset, which contain the results of all points.
+ * The unused bits of the last word are zero.
+ *
+ * @param file      output file (e.g. the standard output)
+ * @param result    bitset of the visibilities of all points
+ * @param total     number of all points
+ * @return          true when the results were written, otherwise false
+ */
+bool write_raw(FILE *file, const uint64_t *result, size_t total);
+
+/**
+ * Writes out the results as the intervals of the visible and of the not visible points.
+ * Each interval is written as its length followed by the result of its points, thus
+ * the output _,3v,2u corresponds to the text output _,v,v,v,u,u. The observer splits
+ * the intervals, e.g. 2u,_,1v corresponds to u,u,_,v.
+ *
+ * @param file      output file (e.g. the standard output)
+ * @param result    bitset of the visibilities of all points
+ * @param total     number of all points
+ * @param observer  index of the point, where the observer is placed
+ * @return          true when the results were written, otherwise false
+ */
+bool write_rle(FILE *file, const uint64_t *result, size_t total, size_t observer);
+
+/**
+ * Appends the intervals of the visible points of the given range to the vector as the pairs
+ * of the indices of their first and of their last point. The whole words with the same
+ * results are skipped at once.
+ *
+ * @param result        bitset of the visibilities of the range (bit 0 is the first point of the range)
+ * @param first         index of the first point of the range
+ * @param count         number of the points of the range
+ * @param intervals     output vector of the first and the last indices of the visible intervals
+ */
+void append_intervals(const uint64_t *result, size_t first, size_t count, std::vector<long long> *intervals);
+
+/**
+ * Writes out the results of the grid stored by the rows as the bit raster in the PBM
+ * format, where the visible cell is the black one (1). The plain format (P1) writes
+ * out each row as the line of the characters 0 and 1, the binary format (P4) packs
+ * each row to the bytes starting from the most significant bit.
+ *
+ * @param file      output file (e.g. the standard output)
+ * @param result    bitset of the visibilities of all cells of the grid
+ * @param width     number of the cells within one row
+ * @param height    number of the rows
+ * @param binary    true for the binary format (P4), false for the plain format (P1)
+ * @return          true when the raster was written, otherwise false
+ */
+bool write_raster(FILE *file, const uint64_t *result, size_t width, size_t height, bool binary);
+
+#endif // OUTPUT_H
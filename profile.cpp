@@ -0,0 +1,288 @@
+/**************************************************************
+ * File:		profile.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The module of the terrain profiles used by the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    profile.cpp
+ * @brief   This module contains the implementation of the functions reading the
+ *          binary profiles by the memory mapping and writing them, and of the parser
+ *          of the comma-separated line of sight.
+ */
+
+#include "profile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Number of the altitudes converted at once by the writing of the profile
+#define PROFILE_BLOCK 4096
+
+size_t profile_element_size(uint32_t element_type) {
+    switch (element_type) {
+        case PROFILE_INT32:
+            return sizeof(int32_t);
+        case PROFILE_INT16:
+            return sizeof(int16_t);
+        default:
+            return 0;
+    }
+}
+
+int profile_altitude(const profile_t *profile, uint64_t index) {
+    if (profile->header->element_type == PROFILE_INT16) {
+        return ((const int16_t *) profile->altitudes)[index];
+    }
+    return ((const int32_t *) profile->altitudes)[index];
+}
+
+const char *open_profile(const char *path, profile_t *profile) {
+    // Open the file with the profile only for the reading
+    int file = open(path, O_RDONLY);
+    if (file < 0) {
+        return "cannot open the profile";
+    }
+    // Obtain the size of the file to map it whole
+    struct stat file_stat;
+    if (fstat(file, &file_stat) < 0 || (size_t) file_stat.st_size < sizeof(profile_header_t)) {
+        close(file);
+        return "the profile is too short";
+    }
+    profile->mapping_size = file_stat.st_size;
+    // Map the file to the memory, the pages are shared with all other processes mapping the same file
+    profile->mapping = mmap(nullptr, profile->mapping_size, PROT_READ, MAP_SHARED, file, 0);
+    // The mapping stays valid after the closing of the file
+    close(file);
+    if (profile->mapping == MAP_FAILED) {
+        return "cannot map the profile";
+    }
+    // The header is at the begin of the file and the altitudes are stored directly after it
+    profile->header = (const profile_header_t *) profile->mapping;
+    profile->altitudes = (const char *) profile->mapping + sizeof(profile_header_t);
+
+    // Check the magic number, the element type and the size of the profile
+    const char *error = nullptr;
+    if (memcmp(profile->header->magic, PROFILE_MAGIC, PROFILE_MAGIC_SIZE)) {
+        error = "the file is not the binary profile";
+    } else if (!profile_element_size(profile->header->element_type)) {
+        error = "unsupported element type of the profile";
+    } else if (profile->header->count > (profile->mapping_size - sizeof(profile_header_t)) /
+                                        profile_element_size(profile->header->element_type)) {
+        error = "the profile is truncated";
+    } else if (profile->header->count && profile->header->observer >= profile->header->count) {
+        error = "the observer is out of the profile";
+    }
+    // Unmap the invalid profile
+    if (error) {
+        close_profile(profile);
+    }
+    return error;
+}
+
+void close_profile(profile_t *profile) {
+    // Unmap the whole mapped file
+    munmap(profile->mapping, profile->mapping_size);
+    profile->mapping = nullptr;
+}
+
+const char *open_profile_stream(const char *path, int *file, profile_header_t *header) {
+    // Open the file with the profile only for the reading
+    *file = open(path, O_RDONLY);
+    if (*file < 0) {
+        return "cannot open the profile";
+    }
+    // Obtain the size of the file to check the number of the stored altitudes
+    struct stat file_stat;
+    const char *error = nullptr;
+    if (fstat(*file, &file_stat) < 0 || (size_t) file_stat.st_size < sizeof(profile_header_t) ||
+        pread(*file, header, sizeof(profile_header_t), 0) != sizeof(profile_header_t)) {
+        error = "the profile is too short";
+    } else if (memcmp(header->magic, PROFILE_MAGIC, PROFILE_MAGIC_SIZE)) {
+        error = "the file is not the binary profile";
+    } else if (header->element_type != PROFILE_INT32) {
+        error = "unsupported element type of the profile";
+    } else if (header->count > (file_stat.st_size - sizeof(profile_header_t)) / sizeof(int32_t)) {
+        error = "the profile is truncated";
+    } else if (header->count && header->observer >= header->count) {
+        error = "the observer is out of the profile";
+    }
+    // Close the invalid profile
+    if (error) {
+        close(*file);
+    }
+    return error;
+}
+
+bool read_profile_altitudes(int file, uint64_t first, size_t count, int *altitudes) {
+    // The altitudes are stored directly after the header
+    off_t offset = sizeof(profile_header_t) + first * sizeof(int32_t);
+    size_t size = count * sizeof(int32_t), done = 0;
+    // The single read may return only the part of the required bytes
+    while (done < size) {
+        ssize_t received = pread(file, (char *) altitudes + done, size - done, offset + done);
+        if (received <= 0) {
+            return false;
+        }
+        done += received;
+    }
+    return true;
+}
+
+/**
+ * Writes the altitudes converted to the given type after the header of the profile.
+ * The altitudes are converted by the blocks, the whole profile is never copied.
+ */
+template <typename altitude_t>
+static bool write_altitudes(FILE *file, const int *altitudes, uint64_t count) {
+    // All altitudes have to fit to the stored type
+    for (uint64_t i = 0; i < count; i++) {
+        if (altitudes[i] < std::numeric_limits<altitude_t>::min() ||
+            altitudes[i] > std::numeric_limits<altitude_t>::max()) {
+            return false;
+        }
+    }
+    altitude_t block[PROFILE_BLOCK];
+    for (uint64_t first = 0; first < count; first += PROFILE_BLOCK) {
+        size_t size = std::min((uint64_t) PROFILE_BLOCK, count - first);
+        for (size_t i = 0; i < size; i++) {
+            block[i] = altitudes[first + i];
+        }
+        if (fwrite(block, sizeof(altitude_t), size, file) != size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool write_profile(const char *path, const int *altitudes, uint64_t count, uint64_t observer, uint32_t element_type) {
+    // Open (create or truncate) the file for the writing
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    // Prepare the header of the profile
+    profile_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PROFILE_MAGIC, PROFILE_MAGIC_SIZE);
+    header.element_type = element_type;
+    header.count = count;
+    header.observer = observer;
+    // Write the header followed by the altitudes
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    switch (element_type) {
+        case altitude_traits<int32_t>::element_type:
+            written &= write_altitudes<int32_t>(file, altitudes, count);
+            break;
+        case altitude_traits<int16_t>::element_type:
+            written &= write_altitudes<int16_t>(file, altitudes, count);
+            break;
+        default:
+            written = false;
+    }
+    // The profile is written only when also the closing of the file succeeded
+    return (fclose(file) == 0) && written;
+}
+
+const char *open_text(const char *path, text_t *text) {
+    // Open the file with the line of sight only for the reading
+    int file = open(path, O_RDONLY);
+    if (file < 0) {
+        return "cannot open the line of sight";
+    }
+    // Obtain the size of the file to map it whole
+    struct stat file_stat;
+    if (fstat(file, &file_stat) < 0 || !file_stat.st_size) {
+        close(file);
+        return "the line of sight is empty";
+    }
+    text->mapping_size = file_stat.st_size;
+    // Map the file to the memory, the pages are shared with all other processes mapping the same file
+    text->mapping = mmap(nullptr, text->mapping_size, PROT_READ, MAP_SHARED, file, 0);
+    // The mapping stays valid after the closing of the file
+    close(file);
+    if (text->mapping == MAP_FAILED) {
+        text->mapping = nullptr;
+        return "cannot map the line of sight";
+    }
+    text->data = (const char *) text->mapping;
+    // The trailing white characters (e.g. the new line at the end of the file) are not part of the text
+    for (text->length = text->mapping_size; text->length && isspace((unsigned char) text->data[text->length - 1]);) {
+        text->length--;
+    }
+    return nullptr;
+}
+
+void close_text(text_t *text) {
+    // Unmap the whole mapped file, the text given directly is not unmapped
+    if (text->mapping) {
+        munmap(text->mapping, text->mapping_size);
+        text->mapping = nullptr;
+    }
+}
+
+size_t count_altitudes(const char *text, size_t length, size_t begin, size_t end) {
+    // The first altitude starts at the begin of the text
+    size_t count = (begin == 0 && end > 0 && length > 0);
+    // Each other altitude starts after the comma, thus the commas within [begin - 1, end - 1) are counted
+    const char *position = text + (begin ? begin - 1 : 0), *last = text + std::min(end, length) - 1;
+    while (position < last && (position = (const char *) memchr(position, ',', last - position))) {
+        count++;
+        position++;
+    }
+    return count;
+}
+
+size_t parse_altitudes(
+    const char *text, size_t length, size_t begin, size_t skip, size_t count, int *altitudes
+) {
+    // Position of the parsing and the end of the text
+    const char *position = text + begin, *end = text + length;
+    // Find the first altitude starting at or after the given byte - the begin of the text or after the comma
+    if (begin) {
+        position = (const char *) memchr(position - 1, ',', end - position + 1);
+        position = position ? position + 1 : end;
+    }
+    // Skip the required number of the altitudes, each of them is followed by the comma
+    for (; skip && position < end; skip--) {
+        position = (const char *) memchr(position, ',', end - position);
+        position = position ? position + 1 : end;
+    }
+    // Parse the required number of the altitudes without any allocation
+    size_t parsed = 0;
+    for (; parsed < count && position < end; parsed++) {
+        // Skip the leading white characters
+        while (position < end && isspace((unsigned char) *position)) {
+            position++;
+        }
+        // Read the optional sign of the altitude
+        bool negative = (position < end && *position == '-');
+        if (position < end && (*position == '-' || *position == '+')) {
+            position++;
+        }
+        // Accumulate the decimal digits of the altitude
+        int altitude = 0;
+        for (; position < end && (unsigned) (*position - '0') < 10; position++) {
+            altitude = altitude * 10 + (*position - '0');
+        }
+        altitudes[parsed] = negative ? -altitude : altitude;
+        // Move after the comma following the altitude
+        position = (const char *) memchr(position, ',', end - position);
+        position = position ? position + 1 : end;
+    }
+    return parsed;
+}
@@ -0,0 +1,223 @@
+/**************************************************************
+ * File:		profile.h
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The header module of the terrain profiles used by the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    profile.h
+ * @brief   The header module contains the definition of the binary format of the
+ *          terrain profile and the declarations of the functions working with it.
+ *          The binary profile consists of the fixed-size header and of the altitudes
+ *          stored directly after it, thus each process is able to map the file to
+ *          its memory and read its own part of the altitudes without any parsing.
+ *          The module contains also the non-allocating parser of the comma-separated
+ *          line of sight, which parses only the given byte range of the text.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Magic number at the begin of the binary profile
+#define PROFILE_MAGIC "LOSP"
+// Size of the magic number of the binary profile
+#define PROFILE_MAGIC_SIZE 4
+// Element type of the binary profile - altitudes stored as the 32-bit signed integers
+#define PROFILE_INT32 1
+// Element type of the binary profile - altitudes stored as the 16-bit signed integers
+#define PROFILE_INT16 2
+
+/**
+ * The header of the binary profile. The header has 32 bytes, so the altitudes stored
+ * after it are aligned for all supported element types. All values are stored in the
+ * byte order of the machine, which has written the profile.
+ */
+typedef struct profile_header {
+    // Magic number of the binary profile (PROFILE_MAGIC)
+    char magic[PROFILE_MAGIC_SIZE];
+    // Type of the stored altitudes (PROFILE_INT32 or PROFILE_INT16)
+    uint32_t element_type;
+    // Number of the stored altitudes
+    uint64_t count;
+    // Index of the altitude, where the observer is placed
+    uint64_t observer;
+    // Reserved for the future use, it aligns the altitudes after the header
+    uint64_t reserved;
+} profile_header_t;
+
+/**
+ * The binary profile mapped to the memory of the process.
+ */
+typedef struct profile {
+    // Initial address of the mapped file
+    void *mapping;
+    // Size of the mapped file in bytes
+    size_t mapping_size;
+    // Header of the mapped profile
+    const profile_header_t *header;
+    // Altitudes of the mapped profile, stored directly after the header
+    const void *altitudes;
+} profile_t;
+
+/**
+ * The comma-separated line of sight, either given directly or mapped from the file.
+ */
+typedef struct text {
+    // Initial address of the mapped file (nullptr when the text was not mapped)
+    void *mapping;
+    // Size of the mapped file in bytes
+    size_t mapping_size;
+    // Characters of the line of sight (not terminated by the null character)
+    const char *data;
+    // Length of the line of sight in bytes
+    size_t length;
+} text_t;
+
+/**
+ * The traits of the type of the stored altitudes, which binds the type to the element
+ * type of the binary profile.
+ */
+template <typename altitude_t>
+struct altitude_traits;
+
+template <>
+struct altitude_traits<int32_t> {
+    // Element type of the binary profile storing the altitudes of this type
+    static const uint32_t element_type = PROFILE_INT32;
+};
+
+template <>
+struct altitude_traits<int16_t> {
+    // Element type of the binary profile storing the altitudes of this type
+    static const uint32_t element_type = PROFILE_INT16;
+};
+
+/**
+ * Returns the size of the one altitude of the given element type of the binary profile.
+ *
+ * @param element_type  element type of the binary profile
+ * @return              size of the one altitude in bytes, 0 when the element type is not supported
+ */
+size_t profile_element_size(uint32_t element_type);
+
+/**
+ * Returns the altitude of the given index of the mapped profile of any supported element type.
+ *
+ * @param profile   mapped profile
+ * @param index     index of the altitude
+ * @return          altitude converted to the int
+ */
+int profile_altitude(const profile_t *profile, uint64_t index);
+
+/**
+ * Maps the given binary profile to the memory of the process (read-only) and checks
+ * its header. Only the pages of the actually read altitudes are loaded from the file.
+ * The profile may store the altitudes of any supported element type.
+ *
+ * @param path      path to the file with the binary profile
+ * @param profile   output mapped profile
+ * @return          nullptr when the profile was mapped, otherwise the description of the error
+ */
+const char *open_profile(const char *path, profile_t *profile);
+
+/**
+ * Unmaps the given binary profile from the memory of the process.
+ *
+ * @param profile   mapped profile
+ */
+void close_profile(profile_t *profile);
+
+/**
+ * Opens the given binary profile for the reading by the parts instead of its mapping
+ * and reads and checks its header. Only the altitudes stored as the 32-bit integers
+ * are supported.
+ *
+ * @param path      path to the file with the binary profile
+ * @param file      output descriptor of the opened file
+ * @param header    output header of the profile
+ * @return          nullptr when the profile was opened, otherwise the description of the error
+ */
+const char *open_profile_stream(const char *path, int *file, profile_header_t *header);
+
+/**
+ * Reads the given part of the altitudes of the binary profile opened by open_profile_stream.
+ *
+ * @param file      descriptor of the opened profile
+ * @param first     index of the first read altitude
+ * @param count     number of the read altitudes
+ * @param altitudes output array of the read altitudes
+ * @return          true when all altitudes were read, otherwise false
+ */
+bool read_profile_altitudes(int file, uint64_t first, size_t count, int *altitudes);
+
+/**
+ * Writes the given altitudes to the file in the format of the binary profile. The
+ * altitudes are stored as the given element type, thus they have to fit to it.
+ *
+ * @param path          path to the file to write the binary profile to
+ * @param altitudes     altitudes to write
+ * @param count         number of the altitudes
+ * @param observer      index of the altitude, where the observer is placed
+ * @param element_type  element type of the stored altitudes (PROFILE_INT32 or PROFILE_INT16)
+ * @return              true when the profile was written, otherwise false
+ */
+bool write_profile(const char *path, const int *altitudes, uint64_t count, uint64_t observer, uint32_t element_type);
+
+/**
+ * Maps the given text file with the comma-separated line of sight to the memory of
+ * the process (read-only). The trailing white characters are not part of the text.
+ *
+ * @param path      path to the file with the line of sight
+ * @param text      output mapped text
+ * @return          nullptr when the text was mapped, otherwise the description of the error
+ */
+const char *open_text(const char *path, text_t *text);
+
+/**
+ * Unmaps the given text from the memory of the process, when it was mapped.
+ *
+ * @param text      mapped text
+ */
+void close_text(text_t *text);
+
+/**
+ * Counts the altitudes of the comma-separated line of sight, which start within the
+ * given byte range. An altitude starts at the begin of the text and after each comma,
+ * so each altitude is counted exactly in one range of the partitioned text.
+ *
+ * @param text      comma-separated line of sight x_1,x_2,...,x_n
+ * @param length    length of the text in bytes
+ * @param begin     index of the first byte of the range
+ * @param end       index of the byte after the range
+ * @return          number of the altitudes starting within the range
+ */
+size_t count_altitudes(const char *text, size_t length, size_t begin, size_t end);
+
+/**
+ * Parses the altitudes of the comma-separated line of sight, starting from the first
+ * altitude that starts at or after the given byte. The given number of the altitudes is
+ * skipped and the following ones are stored to the given array.
+ *
+ * @param text      comma-separated line of sight x_1,x_2,...,x_n
+ * @param length    length of the text in bytes
+ * @param begin     index of the byte, where the search of the first altitude starts
+ * @param skip      number of the altitudes to skip
+ * @param count     number of the altitudes to parse
+ * @param altitudes output array of the parsed altitudes
+ * @return          number of the parsed altitudes (less than count when the text ends)
+ */
+size_t parse_altitudes(
+    const char *text, size_t length, size_t begin, size_t skip, size_t count, int *altitudes
+);
+
+#endif // PROFILE_H
@@ -0,0 +1,421 @@
+/**************************************************************
+ * File:		server.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The server module of the program implementing Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    server.cpp
+ * @brief   This module contains the implementation of the server mode, which keeps
+ *          the processes and the shared windows alive across the stream of the lines
+ *          of sight. The master process reads the batches of the requests from the
+ *          standard input or from the local socket and broadcasts them to all processes.
+ *          The incremental server keeps one growing line of sight on the master process
+ *          and changes it by the commands of the requests (see incremental.h).
+ */
+
+
+#include "vid.h"
+
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+
+
+const char *open_request_stream(const char *path, request_stream_t *stream) {
+    // The buffer of the requests is shared by all clients
+    stream->buffer.resize(SERVER_BUFFER);
+    stream->length = 0;
+    stream->closed = false;
+    // The requests are read from the standard input and the responses are written to the standard output
+    if (!path) {
+        stream->listener = -1;
+        stream->input = STDIN_FILENO;
+        stream->output = stdout;
+        return nullptr;
+    }
+    // The clients are connected later, the address of the socket is limited by the size of the structure
+    stream->input = -1;
+    stream->output = nullptr;
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return "the path to the socket is too long";
+    }
+    strcpy(address.sun_path, path);
+    // Create the listening socket, the socket left by the previous server is removed
+    stream->listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (stream->listener < 0) {
+        return "cannot create the socket";
+    }
+    unlink(path);
+    if (bind(stream->listener, (struct sockaddr *) &address, sizeof(address)) < 0 ||
+        listen(stream->listener, SOMAXCONN) < 0) {
+        close(stream->listener);
+        return "cannot listen on the socket";
+    }
+    // The disconnected client must not terminate the server by the writing of its responses
+    signal(SIGPIPE, SIG_IGN);
+    return nullptr;
+}
+
+bool read_request_batch(request_stream_t *stream, std::vector<char> *batch) {
+    while (true) {
+        // Wait for the next client of the socket
+        if (stream->input < 0) {
+            int client = accept(stream->listener, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            stream->input = client;
+            stream->output = fdopen(dup(client), "w");
+            stream->length = 0;
+            stream->closed = false;
+        }
+        // The batch consists of all complete lines within the buffer
+        const char *end = (const char *) memrchr(stream->buffer.data(), '\n', stream->length);
+        if (end) {
+            size_t size = end - stream->buffer.data() + 1;
+            batch->assign(stream->buffer.data(), stream->buffer.data() + size);
+            // Move the incomplete line to the begin of the buffer
+            memmove(stream->buffer.data(), stream->buffer.data() + size, stream->length - size);
+            stream->length -= size;
+            return true;
+        }
+        if (stream->closed) {
+            // The last line does not have to be terminated by the new line
+            if (stream->length) {
+                batch->assign(stream->buffer.data(), stream->buffer.data() + stream->length);
+                batch->push_back('\n');
+                stream->length = 0;
+                return true;
+            }
+            // The end of the standard input is the end of the stream
+            if (stream->listener < 0) {
+                return false;
+            }
+            // Disconnect the served client and continue with the next one
+            fclose(stream->output);
+            close(stream->input);
+            stream->input = -1;
+            continue;
+        }
+        // The line longer than the buffer enlarges the buffer
+        if (stream->length == stream->buffer.size()) {
+            stream->buffer.resize(2 * stream->buffer.size());
+        }
+        // Read the next part of the requests, it returns as soon as any data are available
+        ssize_t received = read(stream->input, stream->buffer.data() + stream->length,
+                                stream->buffer.size() - stream->length);
+        if (received > 0) {
+            stream->length += received;
+        } else if (received == 0 || errno != EINTR) {
+            stream->closed = true;
+        }
+    }
+}
+
+void close_request_stream(request_stream_t *stream, const char *path) {
+    // The standard input and output are closed by the runtime
+    if (stream->listener < 0) {
+        return;
+    }
+    // Disconnect the served client and remove the socket
+    if (stream->input >= 0) {
+        fclose(stream->output);
+        close(stream->input);
+    }
+    close(stream->listener);
+    unlink(path);
+}
+
+void reserve_windows(windows_t *windows, const settings_t *settings, const layout_t *layout) {
+    // The node part fits to the allocated windows (all processes of the node have the same node part)
+    if (windows->capacity >= 0 && layout->node_count <= windows->capacity) {
+        return;
+    }
+    // The statuses of the processes have the fixed size, thus they are allocated only once
+    if (windows->capacity < 0) {
+        if (settings->scan == SCAN_LOOKBACK) {
+            windows->status = (scan_status_t *) allocate_node_window(
+                    layout->size, STATUS_UNIT, layout->rank, COUNT, layout, &windows->node_status
+            );
+        }
+    } else {
+        MPI_Win_free(&windows->node_altitudes);
+        MPI_Win_free(&windows->node_results);
+        if (!settings->fused) {
+            MPI_Win_free(&windows->node_angles);
+            MPI_Win_free(&windows->node_prev_angles);
+        }
+    }
+    // At least double the capacity, thus the windows are reallocated only O(log n) times
+    windows->capacity = std::max(layout->node_count, 2 * windows->capacity);
+    // The parts of the processes change with each request, thus no process places the pages of its part
+    size_t capacity = windows->capacity;
+
+    // Allocate shared window to store the altitudes of the node
+    windows->shared_altitudes = (int *) allocate_node_window(
+            capacity, INT_UNIT, 0, 0, layout, &windows->node_altitudes
+    );
+    // Allocate shared window to store the final results of the node
+    windows->result = (uint64_t *) allocate_node_window(
+            RESULT_WORDS(capacity), WORD_UNIT, 0, 0, layout, &windows->node_results
+    );
+    // The fused pipeline needs no shared windows of the angles
+    if (!settings->fused) {
+        // Allocate shared windows to store the computed angles and the maximum previous angles (with the nodes
+        // of the max-prescan tree beyond the last angle)
+        windows->shared_angles = (slope_t *) allocate_node_window(
+                capacity, SLOPE_UNIT, 0, 0, layout, &windows->node_angles
+        );
+        windows->max_previous_angles = (slope_t *) allocate_node_window(
+                capacity + PRESCAN_TAIL(layout->size), SLOPE_UNIT, 0, 0, layout, &windows->node_prev_angles
+        );
+    }
+}
+
+void release_windows(windows_t *windows, const settings_t *settings) {
+    // The windows were never allocated, no long line of sight was served
+    if (windows->capacity < 0) {
+        return;
+    }
+    MPI_Win_free(&windows->node_altitudes);
+    free_windows(windows, settings);
+}
+
+void serve_batch(
+    const std::vector<char> *batch, windows_t *windows, FILE *output, const settings_t *settings, layout_t *layout
+) {
+    // Returns the number of all processes
+    int processes;
+    MPI_Comm_size(MPI_COMM_WORLD, &processes);
+    // Split the batch to the lines, the trailing white characters are not part of the lines
+    std::vector<text_t> lines;
+    for (const char *begin = batch->data(), *end; begin < batch->data() + batch->size(); begin = end + 1) {
+        end = (const char *) memchr(begin, '\n', batch->data() + batch->size() - begin);
+        size_t length = end - begin;
+        while (length && isspace((unsigned char) begin[length - 1])) {
+            length--;
+        }
+        lines.push_back(text_t{nullptr, 0, begin, length});
+    }
+    // Number of the altitudes and the results of each line (only on the master process)
+    std::vector<long long> totals(lines.size(), 0);
+    std::vector<std::vector<uint64_t>> results(lines.size());
+
+    // The long lines of sight are split to all processes and processed one after another
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (lines[i].length < SERVER_SHORT) {
+            continue;
+        }
+        // Count the altitudes of the line in parallel and assign them to the processes
+        std::vector<long long> firsts;
+        int observer_altitude;
+        if (!count_points_to_process(&lines[i], &firsts, &observer_altitude, layout)) {
+            totals[i] = -1;
+            continue;
+        }
+        // Reuse the grow-only windows, each process parses its own part of the line directly to them
+        reserve_windows(windows, settings, layout);
+        parse_points_to_process(windows->shared_altitudes, &lines[i], &firsts, layout);
+        solve_line_of_sight(windows->shared_altitudes, windows, observer_altitude, settings, layout);
+        // Collect the results of all nodes on the master process, the window pointer itself is kept
+        uint64_t *result = windows->result;
+        std::vector<uint64_t> gathered;
+        gather_results(&result, windows->node_results, &gathered, layout);
+        if (layout->world_rank == MASTER) {
+            totals[i] = layout->total_altitudes;
+            results[i].assign(result, result + RESULT_WORDS(layout->total_altitudes));
+        }
+    }
+
+    // The short lines of sight are distributed whole, the least loaded process obtains the next one
+    std::vector<size_t> loads(processes, 0);
+    std::vector<int> owners(lines.size(), -1);
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (lines[i].length < SERVER_SHORT) {
+            owners[i] = std::min_element(loads.begin(), loads.end()) - loads.begin();
+            loads[owners[i]] += lines[i].length + 1;
+        }
+    }
+    // Each process processes its short lines sequentially, it packs the number of the altitudes and the results
+    std::vector<uint64_t> packed;
+    std::vector<int> altitudes;
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (owners[i] != layout->world_rank) {
+            continue;
+        }
+        size_t total = count_altitudes(lines[i].data, lines[i].length, 0, lines[i].length);
+        altitudes.resize(total);
+        parse_altitudes(lines[i].data, lines[i].length, 0, 0, total, altitudes.data());
+        packed.push_back(total);
+        packed.resize(packed.size() + RESULT_WORDS(total));
+        if (total) {
+            sweep_slopes(
+                    altitudes.data(), altitudes[0], 0, total, SLOPE_MIN,
+                    packed.data() + packed.size() - RESULT_WORDS(total), 0
+            );
+        }
+    }
+    // Gather the packed results of all processes to the master process
+    int size = packed.size();
+    std::vector<int> sizes(processes), displacements(processes, 0);
+    MPI_Gather(&size, COUNT, MPI_INT, sizes.data(), COUNT, MPI_INT, MASTER, MPI_COMM_WORLD);
+    std::vector<uint64_t> gathered;
+    if (layout->world_rank == MASTER) {
+        for (int i = 1; i < processes; i++) {
+            displacements[i] = displacements[i - 1] + sizes[i - 1];
+        }
+        gathered.resize(displacements[processes - 1] + sizes[processes - 1]);
+    }
+    MPI_Gatherv(
+            packed.data(), size, MPI_UINT64_T, gathered.data(), sizes.data(), displacements.data(), MPI_UINT64_T,
+            MASTER, MPI_COMM_WORLD
+    );
+    if (layout->world_rank != MASTER) {
+        return;
+    }
+
+    // Master process unpacks the results of the short lines, the processes packed them in the order of the batch
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (owners[i] >= 0) {
+            const uint64_t *position = gathered.data() + displacements[owners[i]];
+            totals[i] = *position;
+            results[i].assign(position + 1, position + 1 + RESULT_WORDS(totals[i]));
+            displacements[owners[i]] += 1 + RESULT_WORDS(totals[i]);
+        }
+    }
+    // Master process writes out the responses in the order of the requests, the invalid request has empty response
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (totals[i] <= 0) {
+            fputc('\n', output);
+        } else if (settings->output == OUTPUT_RLE) {
+            write_rle(output, results[i].data(), totals[i], 0);
+        } else {
+            write_text(output, results[i].data(), totals[i], 0);
+        }
+    }
+    fflush(output);
+}
+
+int serve_requests(const settings_t *settings, layout_t *layout) {
+    // Stream of the requests read by the master process
+    request_stream_t stream;
+    stream.output = nullptr;
+    // Grow-only shared windows reused by all requests
+    windows_t windows;
+    windows.capacity = -1;
+    // The observer is placed at the first altitude of each line of sight
+    layout->observer = 0;
+    // Batch of the requests broadcast to all processes
+    std::vector<char> batch;
+
+    // Master process opens the stream of the requests, all processes finish when it cannot be opened
+    int opened = 1;
+    if (layout->world_rank == MASTER) {
+        const char *error = open_request_stream(settings->socket, &stream);
+        if (error) {
+            report_error(error, layout->world_rank);
+            opened = 0;
+        }
+    }
+    MPI_Bcast(&opened, COUNT, MPI_INT, MASTER, MPI_COMM_WORLD);
+    if (!opened) {
+        return 1;
+    }
+
+    while (true) {
+        // Master process reads the next batch, the negative size is the end of the stream
+        long long size = -1;
+        if (layout->world_rank == MASTER && read_request_batch(&stream, &batch)) {
+            size = batch.size();
+        }
+        MPI_Bcast(&size, COUNT, MPI_LONG_LONG, MASTER, MPI_COMM_WORLD);
+        if (size < 0) {
+            break;
+        }
+        // Broadcast the batch to all processes, each of them splits it to the lines itself
+        batch.resize(size);
+        MPI_Bcast(batch.data(), size, MPI_CHAR, MASTER, MPI_COMM_WORLD);
+        serve_batch(&batch, &windows, stream.output, settings, layout);
+    }
+
+    // free the grow-only shared windows and close the stream of the requests
+    release_windows(&windows, settings);
+    if (layout->world_rank == MASTER) {
+        close_request_stream(&stream, settings->socket);
+    }
+    return 0;
+}
+
+void serve_command(const char *line, size_t length, incremental_t *engine, FILE *output, const settings_t *settings) {
+    // Command appending the altitudes to the end of the line of sight
+    if (length && line[0] == '+') {
+        std::vector<int> altitudes(count_altitudes(line + 1, length - 1, 0, length - 1));
+        parse_altitudes(line + 1, length - 1, 0, 0, altitudes.size(), altitudes.data());
+        incremental_append(engine, altitudes.data(), altitudes.size());
+        fprintf(output, "%zu\n", engine->altitudes.size());
+        return;
+    }
+    // Command changing the altitude of the one point of the line of sight
+    if (length && line[0] == '=') {
+        // The command within the batch is always followed by the new line, which terminates the index
+        char *end;
+        long long index = strtoll(line + 1, &end, 10);
+        if (end < line + length && *end == ',' && index >= 0 && (size_t) index < engine->altitudes.size()) {
+            int altitude = 0;
+            parse_altitudes(end + 1, line + length - end - 1, 0, 0, COUNT, &altitude);
+            fprintf(output, "%zu\n", incremental_set(engine, index, altitude));
+            return;
+        }
+    }
+    // Command writing out the results of the whole line of sight
+    if (length == 1 && line[0] == '?' && !engine->altitudes.empty()) {
+        if (settings->output == OUTPUT_RLE) {
+            write_rle(output, engine->result.data(), engine->altitudes.size(), 0);
+        } else {
+            write_text(output, engine->result.data(), engine->altitudes.size(), 0);
+        }
+        return;
+    }
+    // The invalid command has the empty response
+    fputc('\n', output);
+}
+
+int serve_incremental(const settings_t *settings, layout_t *layout) {
+    // Stream of the commands and the line of sight kept across all clients
+    request_stream_t stream;
+    incremental_t engine;
+    std::vector<char> batch;
+    const char *error = open_request_stream(settings->socket, &stream);
+    if (error) {
+        report_error(error, layout->world_rank);
+        return 1;
+    }
+    while (read_request_batch(&stream, &batch)) {
+        // Execute the commands of the batch one after another, the trailing white characters are not part of them
+        for (const char *begin = batch.data(), *end; begin < batch.data() + batch.size(); begin = end + 1) {
+            end = (const char *) memchr(begin, '\n', batch.data() + batch.size() - begin);
+            size_t length = end - begin;
+            while (length && isspace((unsigned char) begin[length - 1])) {
+                length--;
+            }
+            serve_command(begin, length, &engine, stream.output, settings);
+        }
+        fflush(stream.output);
+    }
+    close_request_stream(&stream, settings->socket);
+    return 0;
+}
@@ -0,0 +1,207 @@
+/**************************************************************
+ * File:		summary.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The module of the summaries of the results of the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    summary.cpp
+ * @brief   This module contains the implementation of the summaries, which replace the
+ *          visibilities of all points by the intervals of the visible points, by their
+ *          number, by the furthest visible point or by the decimated horizon. Each process
+ *          summarizes its own window of the shared windows and only the partial summaries
+ *          are merged on the master process, thus the gathered data do not depend on the
+ *          number of the altitudes, but on the size of the summary.
+ */
+
+
+#include "vid.h"
+
+#include <array>
+
+
+bool parse_summary(const char *kind, settings_t *settings) {
+    if (!strcmp(kind, "intervals")) {
+        settings->summary = SUMMARY_INTERVALS;
+    } else if (!strcmp(kind, "count")) {
+        settings->summary = SUMMARY_COUNT;
+    } else if (!strcmp(kind, "furthest")) {
+        settings->summary = SUMMARY_FURTHEST;
+    } else if (!strncmp(kind, "horizon", strlen("horizon"))) {
+        settings->summary = SUMMARY_HORIZON;
+        settings->horizon_step = HORIZON_STEP;
+        // The step of the samples of the horizon is optionally given after the colon
+        kind += strlen("horizon");
+        if (*kind) {
+            char *end;
+            settings->horizon_step = strtoll(kind + 1, &end, 10);
+            return *kind == ':' && isdigit((unsigned char) kind[1]) && !*end && settings->horizon_step > 0;
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Gathers the partial summaries of all processes to the master process, where they are
+ * concatenated in the order of the ranks.
+ */
+static void gather_partial(
+    const std::vector<long long> *partial, std::vector<long long> *gathered, const layout_t *layout
+) {
+    // Returns the number of all processes
+    int processes, count = partial->size();
+    MPI_Comm_size(layout->comm, &processes);
+    // Master process obtains the sizes of all partial summaries to place them one after another
+    std::vector<int> counts(processes), displacements(processes);
+    MPI_Gather(&count, COUNT, MPI_INT, counts.data(), COUNT, MPI_INT, MASTER, layout->comm);
+    if (layout->world_rank == MASTER) {
+        for (int i = 1; i < processes; i++) {
+            displacements[i] = displacements[i - 1] + counts[i - 1];
+        }
+        gathered->resize(displacements[processes - 1] + counts[processes - 1]);
+    }
+    MPI_Gatherv(
+            partial->data(), count, MPI_LONG_LONG, gathered->data(), counts.data(), displacements.data(),
+            MPI_LONG_LONG, MASTER, layout->comm
+    );
+}
+
+/**
+ * Merges the intervals of the visible points, the intervals of the neighbouring windows
+ * are joined, when the first one ends just before the second one.
+ */
+static void merge_intervals(std::vector<long long> *intervals) {
+    // The intervals are sorted by their first points, the ranks may not follow the order of the windows
+    std::vector<std::pair<long long, long long>> pairs(intervals->size() / 2);
+    for (size_t i = 0; i < pairs.size(); i++) {
+        pairs[i] = {(*intervals)[2 * i], (*intervals)[2 * i + 1]};
+    }
+    std::sort(pairs.begin(), pairs.end());
+    intervals->clear();
+    for (const auto &pair : pairs) {
+        if (!intervals->empty() && intervals->back() + 1 == pair.first) {
+            intervals->back() = pair.second;
+        } else {
+            intervals->push_back(pair.first);
+            intervals->push_back(pair.second);
+        }
+    }
+}
+
+void summarize_results(const windows_t *windows, const settings_t *settings, summary_t *summary, const layout_t *layout) {
+    // Index of the first altitude of the process window and the results of the window
+    long long first = layout->node_first + layout->start_idx, observer = layout->observer;
+    const uint64_t *result = (const uint64_t *) query_node_base(windows->node_results, layout->alignment) +
+                             layout->start_idx / WORD_BITS;
+    size_t words = RESULT_WORDS(layout->window_size);
+    std::vector<long long> partial;
+
+    switch (settings->summary) {
+        case SUMMARY_INTERVALS:
+            // Each process finds the intervals within its window, the master joins them across the windows
+            append_intervals(result, first, layout->window_size, &partial);
+            gather_partial(&partial, &summary->values, layout);
+            if (layout->world_rank == MASTER) {
+                merge_intervals(&summary->values);
+            }
+            break;
+        case SUMMARY_COUNT: {
+            // The unused bits of the last word are zero, thus the whole words are counted
+            long long visible = 0;
+            for (size_t word = 0; word < words; word++) {
+                visible += __builtin_popcountll(result[word]);
+            }
+            summary->values.assign(COUNT, 0);
+            MPI_Reduce(&visible, summary->values.data(), COUNT, MPI_LONG_LONG, MPI_SUM, MASTER, layout->comm);
+            break;
+        }
+        case SUMMARY_FURTHEST: {
+            // Distances of the furthest visible points after the observer and before it (-1 when there is none)
+            long long furthest[2] = {-1, -1};
+            for (size_t word = 0; word < words; word++) {
+                if (result[word]) {
+                    long long lowest = first + word * WORD_BITS + __builtin_ctzll(result[word]);
+                    furthest[1] = std::max(furthest[1], observer - lowest);
+                    break;
+                }
+            }
+            for (size_t word = words; word-- > 0;) {
+                if (result[word]) {
+                    long long highest = first + word * WORD_BITS + WORD_BITS - 1 - __builtin_clzll(result[word]);
+                    furthest[0] = std::max(furthest[0], highest - observer);
+                    break;
+                }
+            }
+            summary->values.assign(2, -1);
+            MPI_Reduce(furthest, summary->values.data(), 2, MPI_LONG_LONG, MPI_MAX, MASTER, layout->comm);
+            if (layout->world_rank == MASTER) {
+                // The point after the observer is preferred, when both points are equally far
+                long long after = summary->values[0], before = summary->values[1];
+                summary->values.assign(COUNT, (after < 0 && before < 0) ? -1 :
+                                              (after >= before) ? observer + after : observer - before);
+            }
+            break;
+        }
+        case SUMMARY_HORIZON: {
+            // The horizon at the point is the maximum of its angle and of the maximum previous angle
+            const slope_t *angles = (const slope_t *) query_node_base(windows->node_angles, layout->alignment);
+            const slope_t *previous = (const slope_t *) query_node_base(
+                    windows->node_prev_angles, layout->alignment
+            );
+            long long step = settings->horizon_step, last = first + layout->window_size;
+            // The samples are the multiples of the step and the last point of the line of sight
+            for (long long index = std::max(step, (first + step - 1) / step * step); index < last; index += step) {
+                slope_t horizon = slope_max(angles[index - layout->node_first], previous[index - layout->node_first]);
+                partial.insert(partial.end(), {index, horizon.num, horizon.den});
+            }
+            long long end = layout->total_altitudes - 1;
+            if (end > 0 && end % step && end >= first && end < last) {
+                slope_t horizon = slope_max(angles[end - layout->node_first], previous[end - layout->node_first]);
+                partial.insert(partial.end(), {end, horizon.num, horizon.den});
+            }
+            gather_partial(&partial, &summary->values, layout);
+            if (layout->world_rank == MASTER) {
+                // The samples are sorted by their indices, the ranks may not follow the order of the windows
+                std::vector<std::array<long long, 3>> samples(summary->values.size() / 3);
+                std::memcpy(samples.data(), summary->values.data(), summary->values.size() * sizeof(long long));
+                std::sort(samples.begin(), samples.end());
+                std::memcpy(summary->values.data(), samples.data(), summary->values.size() * sizeof(long long));
+            }
+            break;
+        }
+    }
+}
+
+bool write_summary(FILE *file, const summary_t *summary, const settings_t *settings) {
+    bool written = true;
+    const std::vector<long long> *values = &summary->values;
+    switch (settings->summary) {
+        case SUMMARY_INTERVALS:
+            // Each visible interval is written out as its first and its last point
+            for (size_t i = 0; i < values->size(); i += 2) {
+                written &= fprintf(file, "%lld %lld\n", (*values)[i], (*values)[i + 1]) > 0;
+            }
+            break;
+        case SUMMARY_HORIZON:
+            // Each sample is written out as its index and the tangent of the horizon angle
+            for (size_t i = 0; i < values->size(); i += 3) {
+                written &= fprintf(
+                        file, "%lld %.9g\n", (*values)[i], (double) (*values)[i + 1] / (double) (*values)[i + 2]
+                ) > 0;
+            }
+            break;
+        default:
+            // The number of the visible points or the index of the furthest one
+            written &= fprintf(file, "%lld\n", (*values)[0]) > 0;
+    }
+    return (fflush(file) == 0) && written;
+}
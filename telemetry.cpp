@@ -0,0 +1,169 @@
+/**************************************************************
+ * File:		telemetry.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The module of the telemetry of the processes used by the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    telemetry.cpp
+ * @brief   This module contains the implementation of the start of the telemetry and
+ *          of the gathering and writing out of the records of all processes.
+ */
+
+#include "telemetry.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+// Rank of the master process writing out the gathered records
+#define TELEMETRY_MASTER 0
+// Number of the microseconds within one second
+#define MICROSECONDS 1e6
+// Number of the values sent by one process (the index of its node followed by the values of all phases)
+#define RECORD_VALUES (1 + TELEMETRY_PHASES * TELEMETRY_VALUES)
+
+// Telemetry of the calling process, it is disabled until its start
+telemetry_t telemetry = {false, TELEMETRY_NONE, 0.0, {}};
+
+// Names of the phases written out within the table and the trace
+static const char *phase_names[TELEMETRY_PHASES] = {"load", "angles", "prescan", "results", "gather"};
+
+void telemetry_start(MPI_Comm comm) {
+    telemetry.enabled = true;
+    telemetry.phase = TELEMETRY_NONE;
+    // The clocks start after all processes have reached the barrier
+    MPI_Barrier(comm);
+    telemetry.origin = MPI_Wtime();
+}
+
+/**
+ * Returns the gathered values of the given phase of the given process.
+ */
+static const double *phase_values(const std::vector<double> *records, int rank, int phase) {
+    return records->data() + rank * RECORD_VALUES + 1 + phase * TELEMETRY_VALUES;
+}
+
+/**
+ * Returns the compute time of the given phase record, which is its duration without the waiting.
+ */
+static double compute_time(const double *values) {
+    return std::max(0.0, values[1] - values[0] - values[2]);
+}
+
+/**
+ * Writes out the gathered records as the table of the phases of each process followed by
+ * the summary of each phase with the imbalance of the compute times.
+ */
+static void write_table(FILE *file, const std::vector<double> *records, int processes) {
+    fprintf(file, "%6s %5s %-8s %12s %12s %12s %8s\n", "rank", "node", "phase", "compute_us", "wait_us",
+            "elements", "queries");
+    for (int rank = 0; rank < processes; rank++) {
+        int node = (int) (*records)[rank * RECORD_VALUES];
+        for (int phase = 0; phase < TELEMETRY_PHASES; phase++) {
+            const double *values = phase_values(records, rank, phase);
+            // The phases not reached by the process are not written out
+            if (!values[1]) {
+                continue;
+            }
+            fprintf(file, "%6d %5d %-8s %12.1f %12.1f %12.0f %8.0f\n", rank, node, phase_names[phase],
+                    compute_time(values) * MICROSECONDS, values[2] * MICROSECONDS, values[3], values[4]);
+        }
+    }
+    fprintf(file, "%-8s %16s %16s %16s %10s\n", "phase", "max_compute_us", "mean_compute_us", "max_wait_us",
+            "imbalance");
+    for (int phase = 0; phase < TELEMETRY_PHASES; phase++) {
+        // Maximal and mean compute time and maximal waiting of the processes, which reached the phase
+        double max_compute = 0.0, sum_compute = 0.0, max_wait = 0.0;
+        int reached = 0;
+        for (int rank = 0; rank < processes; rank++) {
+            const double *values = phase_values(records, rank, phase);
+            if (values[1]) {
+                max_compute = std::max(max_compute, compute_time(values));
+                sum_compute += compute_time(values);
+                max_wait = std::max(max_wait, values[2]);
+                reached++;
+            }
+        }
+        if (!reached) {
+            continue;
+        }
+        double mean_compute = sum_compute / reached;
+        fprintf(file, "%-8s %16.1f %16.1f %16.1f %10.2f\n", phase_names[phase], max_compute * MICROSECONDS,
+                mean_compute * MICROSECONDS, max_wait * MICROSECONDS,
+                mean_compute > 0.0 ? max_compute / mean_compute : 1.0);
+    }
+}
+
+/**
+ * Writes out the gathered records as the complete events of the Chrome trace format,
+ * where each process is the thread of the process of its node.
+ */
+static bool write_trace(const char *path, const std::vector<double> *records, int processes) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+    bool written = fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") > 0;
+    const char *delimiter = "";
+    for (int rank = 0; rank < processes; rank++) {
+        int node = (int) (*records)[rank * RECORD_VALUES];
+        for (int phase = 0; phase < TELEMETRY_PHASES; phase++) {
+            const double *values = phase_values(records, rank, phase);
+            if (!values[1]) {
+                continue;
+            }
+            written &= fprintf(
+                    file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                          "\"args\":{\"compute_us\":%.3f,\"wait_us\":%.3f,\"elements\":%.0f,\"queries\":%.0f}}",
+                    delimiter, phase_names[phase], node, rank, values[0] * MICROSECONDS,
+                    (values[1] - values[0]) * MICROSECONDS, compute_time(values) * MICROSECONDS,
+                    values[2] * MICROSECONDS, values[3], values[4]
+            ) > 0;
+            delimiter = ",";
+        }
+    }
+    written &= fprintf(file, "\n]}\n") > 0;
+    return (fclose(file) == 0) && written;
+}
+
+bool telemetry_report(MPI_Comm comm, int node, bool table, const char *trace) {
+    int rank, processes;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &processes);
+    // Each process packs the index of its node followed by the values of all its phases
+    std::vector<double> values(RECORD_VALUES);
+    values[0] = node;
+    for (int phase = 0; phase < TELEMETRY_PHASES; phase++) {
+        const phase_record_t *record = &telemetry.phases[phase];
+        double *packed = values.data() + 1 + phase * TELEMETRY_VALUES;
+        packed[0] = record->start;
+        packed[1] = record->end;
+        packed[2] = record->wait;
+        packed[3] = (double) record->elements;
+        packed[4] = (double) record->queries;
+    }
+    // Gather the records of all processes to the master process
+    std::vector<double> records;
+    if (rank == TELEMETRY_MASTER) {
+        records.resize(values.size() * processes);
+    }
+    MPI_Gather(
+            values.data(), values.size(), MPI_DOUBLE, records.data(), values.size(), MPI_DOUBLE, TELEMETRY_MASTER,
+            comm
+    );
+    if (rank != TELEMETRY_MASTER) {
+        return true;
+    }
+    if (table) {
+        write_table(stderr, &records, processes);
+    }
+    return !trace || write_trace(trace, &records, processes);
+}
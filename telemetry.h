@@ -0,0 +1,185 @@
+/**************************************************************
+ * File:		telemetry.h
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The header module of the telemetry of the processes used by the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    telemetry.h
+ * @brief   The header module contains the declarations of the opt-in telemetry of
+ *          the pipeline. Each process records for each phase its compute time, the time
+ *          spent by waiting for the other processes (barriers, collectives and spinning
+ *          on the statuses of the predecessors), the number of the processed altitudes
+ *          and the number of the queries of the shared windows. The records of all
+ *          processes are gathered to the master process, which writes them out as the
+ *          table or as the trace in the Chrome trace format. When the telemetry is not
+ *          enabled, each recording function only checks the flag and returns.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <mpi.h>
+
+// Phase of the parsing of the line of sight to the shared memory
+#define TELEMETRY_LOAD 0
+// Phase of the computation of the angles
+#define TELEMETRY_ANGLES 1
+// Phase of the max-prescan of the angles
+#define TELEMETRY_PRESCAN 2
+// Phase of the computation of the results (the whole fused or sequential pipeline)
+#define TELEMETRY_RESULTS 3
+// Phase of the gathering of the results to the master process
+#define TELEMETRY_GATHER 4
+// Number of the recorded phases
+#define TELEMETRY_PHASES 5
+// No phase is recorded, the waiting and the queries are not assigned to any phase
+#define TELEMETRY_NONE (-1)
+// Number of the values of one phase sent to the master process (start, end, wait, elements, queries)
+#define TELEMETRY_VALUES 5
+
+/**
+ * The record of one phase of the pipeline within one process. The times are measured
+ * in seconds from the start of the telemetry, the compute time is the duration of the
+ * phase without the time of the waiting.
+ */
+typedef struct phase_record {
+    // Time of the first begin and of the last end of the phase
+    double start, end;
+    // Time spent by waiting for the other processes within the phase
+    double wait;
+    // Number of the altitudes processed by the process within the phase
+    long long elements;
+    // Number of the queries of the shared windows within the phase
+    long long queries;
+} phase_record_t;
+
+/**
+ * The telemetry of the calling process.
+ */
+typedef struct telemetry {
+    // Flag whether the telemetry is recorded
+    bool enabled;
+    // Currently recorded phase (TELEMETRY_NONE outside of the phases)
+    int phase;
+    // Time of the start of the telemetry, the recorded times are relative to it
+    double origin;
+    // Records of all phases
+    phase_record_t phases[TELEMETRY_PHASES];
+} telemetry_t;
+
+// Telemetry of the calling process
+extern telemetry_t telemetry;
+
+/**
+ * Enables the telemetry and starts its clock after the barrier, thus the clocks of
+ * all processes start at almost the same time.
+ *
+ * @param comm  communicator of all processes
+ */
+void telemetry_start(MPI_Comm comm);
+
+/**
+ * Begins the given phase or continues it, when it was already recorded. The processed
+ * altitudes are added to the altitudes of the phase.
+ *
+ * @param phase     index of the phase (TELEMETRY_LOAD, ...)
+ * @param elements  number of the altitudes processed by the process within the phase
+ */
+inline void telemetry_begin(int phase, long long elements) {
+    if (!telemetry.enabled) {
+        return;
+    }
+    phase_record_t *record = &telemetry.phases[phase];
+    // The repeated phase keeps the time of its first begin
+    if (!record->end) {
+        record->start = MPI_Wtime() - telemetry.origin;
+    }
+    record->elements += elements;
+    telemetry.phase = phase;
+}
+
+/**
+ * Ends the currently recorded phase.
+ */
+inline void telemetry_end() {
+    if (!telemetry.enabled || telemetry.phase == TELEMETRY_NONE) {
+        return;
+    }
+    telemetry.phases[telemetry.phase].end = MPI_Wtime() - telemetry.origin;
+    telemetry.phase = TELEMETRY_NONE;
+}
+
+/**
+ * Returns the current time, when the telemetry is recorded, as the begin of the waiting.
+ *
+ * @return  current time in seconds, otherwise zero
+ */
+inline double telemetry_clock() {
+    return telemetry.enabled ? MPI_Wtime() : 0.0;
+}
+
+/**
+ * Adds the time elapsed from the given begin of the waiting to the waiting of the current phase.
+ *
+ * @param since     begin of the waiting returned by the telemetry_clock
+ */
+inline void telemetry_waited(double since) {
+    if (telemetry.enabled && telemetry.phase != TELEMETRY_NONE) {
+        telemetry.phases[telemetry.phase].wait += MPI_Wtime() - since;
+    }
+}
+
+/**
+ * Blocks until all processes in the communicator have reached the barrier, the blocked
+ * time is the waiting of the current phase.
+ *
+ * @param comm  communicator of the synchronised processes
+ */
+inline void telemetry_barrier(MPI_Comm comm) {
+    double since = telemetry_clock();
+    MPI_Barrier(comm);
+    telemetry_waited(since);
+}
+
+/**
+ * Queries the base pointer of the part of the shared window of the given process and
+ * counts the query within the current phase.
+ *
+ * @param win           shared memory window object
+ * @param rank          rank of the process owning the queried part of the window
+ * @param size          output size of the queried part of the window
+ * @param disp_unit     output local unit size for displacements
+ * @param baseptr       output address of the base pointer of the queried part
+ * @return              error code of the MPI_Win_shared_query
+ */
+inline int telemetry_shared_query(MPI_Win win, int rank, MPI_Aint *size, int *disp_unit, void *baseptr) {
+    if (telemetry.enabled && telemetry.phase != TELEMETRY_NONE) {
+        telemetry.phases[telemetry.phase].queries++;
+    }
+    return MPI_Win_shared_query(win, rank, size, disp_unit, baseptr);
+}
+
+/**
+ * Gathers the records of all processes to the master process, which writes them out
+ * as the table to the standard error output and as the trace in the Chrome trace format
+ * (the events of the phases of each process are the complete events of its own thread
+ * within the process of its node). The table contains for each phase also the imbalance
+ * of the processes, which is the maximal compute time divided by the mean one.
+ *
+ * @param comm      communicator of the participating processes
+ * @param node      index of the node of the calling process
+ * @param table     flag whether the table is written out
+ * @param trace     path to the written trace (nullptr, when no trace is written)
+ * @return          true when the trace was written or not required, otherwise false (only on the master process)
+ */
+bool telemetry_report(MPI_Comm comm, int node, bool table, const char *trace);
+
+#endif // TELEMETRY_H
@@ -7,7 +7,7 @@
 # Faculty: 	  Faculty of Information Technology
 # Course:	    Parallel and Distributed Algorithms
 # Date:		    04.04.2020
-# Last change:08.04.2020
+# Last change:17.10.2026
 #
 # Subscribe:	The test shell script to run algorithm that solve
 #             parallel Line-Of-Sight problem with use max-prescan.
@@ -20,10 +20,15 @@
 #          entered on the command line. When was entered also the
 #          second argument then is computed the relevant number
 #          of processors according to the numbers of the altitudes
-#          in the given line-of-sight. Then this script builds the
+#          in the given line-of-sight, which all participate thanks
+#          to the zero cost model, otherwise all available
+#          processors are started and the program itself parks the
+#          surplus ones by its cost model. Then this script builds the
 #          program and subseqenlty runs with the computed numbers
 #          of processors. In the end it removes all created files
-#          during its execution.
+#          during its execution. The environment variable
+#          BACKEND=threads builds the multithreaded backend instead,
+#          which runs the computed number of threads without MPI.
 #####
 
 # check whether the input line of sight was entered, otherwise error
@@ -43,6 +48,8 @@ POINTS_NUMBER=${#ARR[@]}
 # comput the numbers of processor according to given second argument or by default
 if  [ "$#" -eq 2 ]
 then
+  # the zero cost model keeps all computed processors participating
+  MODEL="-m 0,0"
   # compute the number of processor according to formula n/p >= lg p
   if [ "$2" -eq 1 ]
   then
@@ -59,16 +66,21 @@ then
   else
     PROCESSORS=1
   fi
-# default value is compute according to the rule n/p >= lg p
+# by default all available processors are started, the program chooses the participating ones
 else
-  PROCESSORS=$(python3 -c "from scipy import optimize; import scipy; import numpy; print(int(numpy.ceil(scipy.optimize.fsolve(lambda x: $POINTS_NUMBER - numpy.lib.scimath.log2(x) * x, 5)[0])))")
+  PROCESSORS=$(nproc)
+  MODEL=""
 fi
 
-# compile source code
-mpic++ --prefix /usr/local/share/OpenMPI -o vid vid.cpp
-
-# run binary
-mpirun --prefix /usr/local/share/OpenMPI -np "$PROCESSORS" vid "$LINE_OF_SIGHT"
+# compile source code and run binary, the environment variable BACKEND=threads selects the backend without MPI
+if [ "$BACKEND" = "threads" ]
+then
+  g++ -O2 -march=native -pthread -DTHREADS_BACKEND -o vid threads.cpp kernel.cpp output.cpp profile.cpp
+  ./vid -j "$PROCESSORS" "$LINE_OF_SIGHT"
+else
+  mpic++ --prefix /usr/local/share/OpenMPI -O2 -march=native -o vid vid.cpp kernel.cpp output.cpp profile.cpp server.cpp incremental.cpp viewshed.cpp tiled.cpp bench.cpp telemetry.cpp batch.cpp summary.cpp
+  mpirun --prefix /usr/local/share/OpenMPI -np "$PROCESSORS" vid $MODEL "$LINE_OF_SIGHT"
+fi
 
 # clean directory
 rm -f vid
\ No newline at end of file
@@ -0,0 +1,378 @@
+/**************************************************************
+ * File:		threads.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The module of the multithreaded backend of the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    threads.cpp
+ * @brief   This module contains the implementation of the multithreaded backend
+ *          running the same pipeline as the fused pipeline of the MPI processes on
+ *          the threads of one process. The main function is compiled only with the
+ *          defined THREADS_BACKEND, otherwise the module contains only the backend.
+ */
+
+#include "threads.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+#include "output.h"
+#include "profile.h"
+
+bool parse_thread_arguments(int argc, char **argv, thread_settings_t *settings) {
+    // Definition of the long options of the backend, they are the same as the options of the MPI program
+    static const struct option long_options[] = {
+            {"input", required_argument, nullptr, 'i'},
+            {"text", required_argument, nullptr, 't'},
+            {"output", required_argument, nullptr, 'o'},
+            {"observer", required_argument, nullptr, 'x'},
+            {"threads", required_argument, nullptr, 'j'},
+            {nullptr, 0, nullptr, 0}
+    };
+    // Default settings - all available processors and the text output
+    settings->line_of_sight = nullptr;
+    settings->input = nullptr;
+    settings->text = nullptr;
+    settings->output = OUTPUT_TEXT;
+    settings->observer = -1;
+    settings->threads = std::max(1u, std::thread::hardware_concurrency());
+    // Errors are reported by the usage of the program
+    opterr = 0;
+    // Walk through all options given on the command line
+    int option;
+    while ((option = getopt_long(argc, argv, "i:t:o:x:j:", long_options, nullptr)) != -1) {
+        switch (option) {
+            // Binary profile used instead of the line of sight
+            case 'i':
+                settings->input = optarg;
+                break;
+            // File with the line of sight used instead of the line of sight on the command line
+            case 't':
+                settings->text = optarg;
+                break;
+            // Format of the written results
+            case 'o':
+                if (!strcmp(optarg, "text")) {
+                    settings->output = OUTPUT_TEXT;
+                } else if (!strcmp(optarg, "raw")) {
+                    settings->output = OUTPUT_RAW;
+                } else if (!strcmp(optarg, "rle")) {
+                    settings->output = OUTPUT_RLE;
+                } else {
+                    return false;
+                }
+                break;
+            // Index of the altitude, where the observer is placed
+            case 'x': {
+                char *end;
+                settings->observer = strtoll(optarg, &end, 10);
+                if (*end || settings->observer < 0) {
+                    return false;
+                }
+                break;
+            }
+            // Number of the threads
+            case 'j': {
+                char *end;
+                long threads = strtol(optarg, &end, 10);
+                if (*end || threads <= 0 || threads > INT_MAX) {
+                    return false;
+                }
+                settings->threads = threads;
+                break;
+            }
+            // Unknown option or missing argument of the option
+            default:
+                return false;
+        }
+    }
+    // The binary profile or the file with the line of sight replace the positional argument
+    if (settings->input || settings->text) {
+        return optind == argc && !(settings->input && settings->text);
+    }
+    // The line of sight is the only positional argument
+    if (optind != argc - 1) {
+        return false;
+    }
+    settings->line_of_sight = argv[optind];
+    return true;
+}
+
+void barrier_init(thread_barrier_t *barrier, int threads) {
+    barrier->arrived.store(0, std::memory_order_relaxed);
+    barrier->generation.store(0, std::memory_order_relaxed);
+    barrier->threads = threads;
+}
+
+void barrier_wait(thread_barrier_t *barrier) {
+    // The generation is read before the arrival, thus the last thread cannot increment it before
+    int generation = barrier->generation.load(std::memory_order_acquire);
+    // The last arriving thread resets the barrier for its next use and releases the waiting threads
+    if (barrier->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == barrier->threads) {
+        barrier->arrived.store(0, std::memory_order_relaxed);
+        barrier->generation.fetch_add(1, std::memory_order_release);
+        syscall(SYS_futex, (int *) &barrier->generation, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        return;
+    }
+    // The short waiting is spent by spinning, the longer one by sleeping on the futex of the generation
+    for (int i = 0; i < BARRIER_SPINS; i++) {
+        if (barrier->generation.load(std::memory_order_acquire) != generation) {
+            return;
+        }
+    }
+    while (barrier->generation.load(std::memory_order_acquire) == generation) {
+        syscall(SYS_futex, (int *) &barrier->generation, FUTEX_WAIT_PRIVATE, generation, nullptr, nullptr, 0);
+    }
+}
+
+void split_chunks(std::vector<chunk_range_t> *ranges, size_t chunks, int threads) {
+    *ranges = std::vector<chunk_range_t>(threads);
+    for (int i = 0; i < threads; i++) {
+        uint64_t first = chunks * i / threads, last = chunks * (i + 1) / threads;
+        (*ranges)[i].bounds.store(first << 32 | last, std::memory_order_relaxed);
+    }
+}
+
+long long take_chunk(std::vector<chunk_range_t> *ranges, int thread) {
+    int threads = ranges->size();
+    // The own range is tried first, then the ranges of the following threads
+    for (int i = 0; i < threads; i++) {
+        bool own = !i;
+        std::atomic<uint64_t> *bounds = &(*ranges)[(thread + i) % threads].bounds;
+        uint64_t current = bounds->load(std::memory_order_relaxed);
+        while ((current >> 32) < (current & UINT32_MAX)) {
+            // The owner takes the first chunk of the range, the thief takes the last one
+            uint64_t taken = own ? current + (1ULL << 32) : current - 1;
+            if (bounds->compare_exchange_weak(current, taken, std::memory_order_relaxed)) {
+                return own ? (long long) (current >> 32) : (long long) (taken & UINT32_MAX);
+            }
+        }
+    }
+    return -1;
+}
+
+void parse_in_threads(const char *text, size_t length, int threads, std::vector<int> *altitudes) {
+    // firsts[t] = index of the first altitude starting within the byte range t
+    std::vector<size_t> firsts(threads + 1, 0);
+    std::vector<std::thread> pool;
+    // Each thread counts the altitudes starting within its equal byte range of the text
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t]() {
+            firsts[t + 1] = count_altitudes(text, length, length * t / threads, length * (t + 1) / threads);
+        });
+    }
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+    for (int t = 0; t < threads; t++) {
+        firsts[t + 1] += firsts[t];
+    }
+    altitudes->resize(firsts[threads]);
+    pool.clear();
+    // Each thread parses the altitudes of its byte range directly to their places
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t]() {
+            parse_altitudes(
+                    text, length, length * t / threads, 0, firsts[t + 1] - firsts[t], altitudes->data() + firsts[t]
+            );
+        });
+    }
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+}
+
+void solve_in_thread(thread_work_t *work, int thread) {
+    size_t observer = work->observer;
+    long long chunk;
+    // The first pass: the maximums of the slopes on both sides of the observer within each taken chunk
+    while ((chunk = take_chunk(&work->reduce_ranges, thread)) >= 0) {
+        size_t first = chunk * THREAD_CHUNK, last = std::min(work->total, first + THREAD_CHUNK);
+        size_t right = std::max(first, observer + 1), left_end = std::min(last, observer);
+        work->right_max[chunk] = (right < last) ? max_altitude_slope(
+                work->altitudes + right, work->observer_altitude, right - observer, last - right, SLOPE_MIN
+        ) : SLOPE_MIN;
+        work->left_max[chunk] = (first < left_end) ? max_altitude_slope_backward(
+                work->altitudes + first, work->observer_altitude, observer - left_end + 1, left_end - first, SLOPE_MIN
+        ) : SLOPE_MIN;
+    }
+    barrier_wait(&work->barrier);
+
+    // The second level of the max-prescan: the exclusive scans of the maximums of the chunks
+    if (thread == 0) {
+        slope_t running = SLOPE_MIN;
+        for (size_t c = 0; c < work->chunks; c++) {
+            work->right_offset[c] = running;
+            running = slope_max(running, work->right_max[c]);
+        }
+        running = SLOPE_MIN;
+        for (size_t c = work->chunks; c-- > 0;) {
+            work->left_offset[c] = running;
+            running = slope_max(running, work->left_max[c]);
+        }
+    }
+    barrier_wait(&work->barrier);
+
+    // The second pass: the angles, their running maximums and the results of each taken chunk at once
+    while ((chunk = take_chunk(&work->sweep_ranges, thread)) >= 0) {
+        size_t first = chunk * THREAD_CHUNK, last = std::min(work->total, first + THREAD_CHUNK);
+        size_t right = std::max(first, observer + 1), left_end = std::min(last, observer);
+        uint64_t *chunk_result = work->result + first / WORD_BITS;
+        memset(chunk_result, 0, (last - first + WORD_BITS - 1) / WORD_BITS * sizeof(uint64_t));
+        if (right < last) {
+            sweep_slopes(
+                    work->altitudes + right, work->observer_altitude, right - observer, last - right,
+                    work->right_offset[chunk], chunk_result, right - first
+            );
+        }
+        if (first < left_end) {
+            sweep_slopes_backward(
+                    work->altitudes + first, work->observer_altitude, observer - left_end + 1, left_end - first,
+                    work->left_offset[chunk], chunk_result, 0
+            );
+        }
+    }
+}
+
+void solve_with_threads(const int *altitudes, size_t total, size_t observer, int threads, uint64_t *result) {
+    thread_work_t work;
+    work.total = total;
+    work.observer = observer;
+    work.observer_altitude = altitudes[observer];
+    work.altitudes = altitudes;
+    work.result = result;
+    work.chunks = (total + THREAD_CHUNK - 1) / THREAD_CHUNK;
+    // More threads than the chunks would have nothing to do
+    work.threads = std::max(1, (int) std::min((size_t) threads, work.chunks));
+    work.right_max.resize(work.chunks);
+    work.left_max.resize(work.chunks);
+    work.right_offset.resize(work.chunks);
+    work.left_offset.resize(work.chunks);
+    split_chunks(&work.reduce_ranges, work.chunks, work.threads);
+    split_chunks(&work.sweep_ranges, work.chunks, work.threads);
+    barrier_init(&work.barrier, work.threads);
+    // The calling thread is the thread 0, the other threads are started for the computation
+    std::vector<std::thread> pool;
+    for (int t = 1; t < work.threads; t++) {
+        pool.emplace_back(solve_in_thread, &work, t);
+    }
+    solve_in_thread(&work, 0);
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+}
+
+#ifdef THREADS_BACKEND
+
+int main(int argc, char **argv) {
+    // Settings of the backend given on the command line
+    thread_settings_t settings;
+    // Line of sight given on the command line or mapped from the file
+    text_t text;
+    // Binary profile mapped instead of the line of sight
+    profile_t profile;
+    // Parsed altitudes of the line of sight (the altitudes of the profile are used directly)
+    std::vector<int> parsed;
+    const int *altitudes;
+    size_t total, observer = 0;
+
+    if (!parse_thread_arguments(argc, argv, &settings)) {
+        fprintf(stderr, THREADS_USAGE);
+        return 1;
+    }
+    if (settings.input) {
+        // The altitudes and the observer are read directly from the mapped profile
+        const char *error = open_profile(settings.input, &profile);
+        if (error) {
+            fprintf(stderr, "vid: %s\n", error);
+            return 1;
+        }
+        if (profile.header->element_type != PROFILE_INT32) {
+            fprintf(stderr, "vid: unsupported element type of the profile\n");
+            close_profile(&profile);
+            return 1;
+        }
+        if (!profile.header->count || profile.header->count > INT_MAX) {
+            fprintf(stderr, "vid: unsupported number of the altitudes in the profile\n");
+            close_profile(&profile);
+            return 1;
+        }
+        altitudes = (const int *) profile.altitudes;
+        total = profile.header->count;
+        observer = profile.header->observer;
+    } else {
+        // The line of sight is given on the command line or mapped from the file
+        if (settings.text) {
+            const char *error = open_text(settings.text, &text);
+            if (error) {
+                fprintf(stderr, "vid: %s\n", error);
+                return 1;
+            }
+        } else {
+            text.mapping = nullptr;
+            text.data = settings.line_of_sight;
+            text.length = strlen(settings.line_of_sight);
+        }
+        parse_in_threads(text.data, text.length, settings.threads, &parsed);
+        if (settings.text) {
+            close_text(&text);
+        }
+        if (parsed.empty() || parsed.size() > INT_MAX) {
+            fprintf(stderr, "vid: unsupported number of the altitudes in the line of sight\n");
+            return 1;
+        }
+        altitudes = parsed.data();
+        total = parsed.size();
+    }
+    // The observer given on the command line overrides the observer of the profile
+    if (settings.observer >= 0) {
+        if ((size_t) settings.observer >= total) {
+            fprintf(stderr, "vid: the observer is out of the line of sight\n");
+            if (settings.input) {
+                close_profile(&profile);
+            }
+            return 1;
+        }
+        observer = settings.observer;
+    }
+
+    // Compute the final results by the threads and write them out in the selected format
+    std::vector<uint64_t> result((total + WORD_BITS - 1) / WORD_BITS);
+    solve_with_threads(altitudes, total, observer, settings.threads, result.data());
+    bool written;
+    switch (settings.output) {
+        case OUTPUT_RAW:
+            written = write_raw(stdout, result.data(), total);
+            break;
+        case OUTPUT_RLE:
+            written = write_rle(stdout, result.data(), total, observer);
+            break;
+        default:
+            written = write_text(stdout, result.data(), total, observer);
+    }
+    if (!written) {
+        fprintf(stderr, "vid: cannot write out the results\n");
+    }
+    if (settings.input) {
+        close_profile(&profile);
+    }
+    return written ? 0 : 1;
+}
+
+#endif // THREADS_BACKEND
@@ -0,0 +1,197 @@
+/**************************************************************
+ * File:		threads.h
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The header module of the multithreaded backend of the Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    threads.h
+ * @brief   The header module contains the definitions and the declarations of the
+ *          backend, which solves the line of sight by the threads of one process
+ *          instead of the MPI processes. The backend is selected at compile time by
+ *          building the threads.cpp (defining THREADS_BACKEND) instead of the vid.cpp,
+ *          it needs no MPI and it writes out the results in the same formats:
+ *
+ *              g++ -O2 -march=native -pthread -DTHREADS_BACKEND -o vid \
+ *                  threads.cpp kernel.cpp output.cpp profile.cpp
+ *
+ *          The altitudes are split to the chunks of THREAD_CHUNK altitudes. Each thread
+ *          owns the contiguous range of the chunks and it steals the chunks from the end
+ *          of the ranges of the other threads, when its own range is exhausted. The
+ *          max-prescan has two levels - the maximums of the chunks are reduced in
+ *          parallel, their exclusive scan is computed by one thread and the chunks are
+ *          swept in parallel with the scanned maximums as their offsets.
+ */
+
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "kernel.h"
+
+// Number of the altitudes of one chunk of the work (multiple of WORD_BITS, the chunks never share a word)
+#define THREAD_CHUNK (1 << 16)
+// Number of the checks of the barrier by spinning before the thread sleeps on the futex
+#define BARRIER_SPINS 4096
+// Usage of the program written out when the arguments are not valid
+#define THREADS_USAGE "Usage: vid [-o text|raw|rle] [-x OBSERVER] [-j THREADS] LINE_OF_SIGHT | -t FILE | -i PROFILE\n"
+
+/**
+ * The settings of the multithreaded backend given on the command line.
+ */
+typedef struct thread_settings {
+    // Input line of sight in the format x_1,x_2,...,x_n
+    char *line_of_sight;
+    // Path to the input binary profile, which is used instead of the line of sight
+    char *input;
+    // Path to the file with the line of sight, which is used instead of the line of sight on the command line
+    char *text;
+    // Format of the written results (OUTPUT_TEXT, OUTPUT_RAW or OUTPUT_RLE)
+    int output;
+    // Index of the altitude, where the observer is placed (-1 when it is not given)
+    long long observer;
+    // Number of the threads (the number of the available processors by default)
+    int threads;
+} thread_settings_t;
+
+/**
+ * The barrier of the threads. The threads spin for BARRIER_SPINS checks of the generation
+ * and then they sleep on the futex of the generation, which the last arriving thread
+ * increments and wakes all sleeping threads.
+ */
+typedef struct thread_barrier {
+    // Number of the threads arrived to the current generation of the barrier
+    std::atomic<int> arrived;
+    // Generation of the barrier, which is incremented by the last arriving thread
+    std::atomic<int> generation;
+    // Number of the synchronised threads
+    int threads;
+} thread_barrier_t;
+
+/**
+ * The range of the chunks owned by one thread. The first chunk and the chunk after the
+ * last one are packed to the one word, thus the owner taking the chunks from the begin
+ * and the thieves taking them from the end change the range by the one atomic operation.
+ * The range occupies the whole cache line.
+ */
+typedef struct alignas(64) chunk_range {
+    // Index of the first chunk (upper half) and of the chunk after the last one (lower half)
+    std::atomic<uint64_t> bounds;
+} chunk_range_t;
+
+/**
+ * The state of the computation shared by all threads.
+ */
+typedef struct thread_work {
+    // Number of the threads
+    int threads;
+    // Number of all altitudes
+    size_t total;
+    // Index of the altitude, where the observer is placed, and its altitude
+    size_t observer;
+    int observer_altitude;
+    // Number of the chunks of the altitudes
+    size_t chunks;
+    // Altitudes of the line of sight
+    const int *altitudes;
+    // Bitset of the final results
+    uint64_t *result;
+    // Maximums of the slopes after the observer and before it within each chunk
+    std::vector<slope_t> right_max, left_max;
+    // Maximums of the slopes preceding each chunk after the observer and following each chunk before it
+    std::vector<slope_t> right_offset, left_offset;
+    // Ranges of the chunks of the threads for the reduction and for the sweep
+    std::vector<chunk_range_t> reduce_ranges, sweep_ranges;
+    // Barrier separating the phases of the computation
+    thread_barrier_t barrier;
+} thread_work_t;
+
+/**
+ * Parses the arguments given on the command line to the settings of the backend.
+ *
+ * @param argc          number of the arguments
+ * @param argv          arguments given on the command line
+ * @param settings      output settings of the backend
+ * @return              true when the arguments are valid, otherwise false
+ */
+bool parse_thread_arguments(int argc, char **argv, thread_settings_t *settings);
+
+/**
+ * Initializes the barrier for the given number of the threads.
+ *
+ * @param barrier   initialized barrier
+ * @param threads   number of the synchronised threads
+ */
+void barrier_init(thread_barrier_t *barrier, int threads);
+
+/**
+ * Blocks until all threads have reached the barrier.
+ *
+ * @param barrier   barrier of the threads
+ */
+void barrier_wait(thread_barrier_t *barrier);
+
+/**
+ * Splits the given number of the chunks to the contiguous ranges of the threads.
+ *
+ * @param ranges    output ranges of the threads
+ * @param chunks    number of all chunks
+ * @param threads   number of the threads
+ */
+void split_chunks(std::vector<chunk_range_t> *ranges, size_t chunks, int threads);
+
+/**
+ * Takes the next chunk of the work. The thread takes the first chunk of its own range,
+ * when the range is exhausted, it steals the last chunk of the range of the other threads.
+ *
+ * @param ranges    ranges of the chunks of all threads
+ * @param thread    index of the calling thread
+ * @return          index of the taken chunk, -1 when all chunks were taken
+ */
+long long take_chunk(std::vector<chunk_range_t> *ranges, int thread);
+
+/**
+ * Parses the line of sight by all threads, each thread parses the altitudes starting
+ * within its equal byte range of the text.
+ *
+ * @param text          comma-separated line of sight
+ * @param length        length of the text in bytes
+ * @param threads       number of the threads
+ * @param altitudes     output vector of the parsed altitudes
+ */
+void parse_in_threads(const char *text, size_t length, int threads, std::vector<int> *altitudes);
+
+/**
+ * Computes the results of the chunks by the calling thread. The thread reduces the
+ * maximums of the slopes of the taken chunks, the thread 0 scans the maximums of all
+ * chunks and each thread sweeps the taken chunks with their scanned offsets.
+ *
+ * @param work      state of the computation shared by all threads
+ * @param thread    index of the calling thread
+ */
+void solve_in_thread(thread_work_t *work, int thread);
+
+/**
+ * Computes the results of the line of sight by the given number of the threads.
+ * The calling thread is the thread 0 of the computation.
+ *
+ * @param altitudes             altitudes of the line of sight
+ * @param total                 number of the altitudes
+ * @param observer              index of the altitude, where the observer is placed
+ * @param threads               number of the threads
+ * @param result                output bitset of the visibilities of all altitudes
+ */
+void solve_with_threads(const int *altitudes, size_t total, size_t observer, int threads, uint64_t *result);
+
+#endif // THREADS_H
@@ -0,0 +1,118 @@
+/**************************************************************
+ * File:		tiled.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The tiled module of the program implementing Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    tiled.cpp
+ * @brief   This module contains the implementation of the out-of-core processing of the
+ *          binary profiles larger than the memory. The profile is read by the tiles of
+ *          the fixed size into two alternating buffers, the next tile is read by the
+ *          asynchronous task during the sweep of the current one. The running maximum of
+ *          the slopes is carried from the tile to the tile and the results of each tile
+ *          are written out as soon as it is swept, thus the memory does not depend on
+ *          the number of the altitudes.
+ */
+
+
+#include "vid.h"
+
+#include <future>
+
+
+wide_slope_t sweep_tile(
+    const int *altitudes, int observer_altitude, uint64_t first, size_t count, wide_slope_t running,
+    uint64_t *result
+) {
+    // The wide slopes are needed only for the distances, which do not fit to the int
+    if (first + count > (uint64_t) INT_MAX + 1) {
+        return sweep_slopes_wide(altitudes, observer_altitude, first, count, running, result, 0);
+    }
+    // The running maximum of the preceding tiles has the distance less than the first one, it fits to the int
+    slope_t narrow = sweep_slopes(
+            altitudes, observer_altitude, first, count, slope_t{(int) running.num, (int) running.den}, result, 0
+    );
+    return wide_slope_t{narrow.num, narrow.den};
+}
+
+int process_tiles(const settings_t *settings, const layout_t *layout) {
+    // The tiles are read and swept by the master process only, the bandwidth of the storage is the limit
+    if (layout->world_rank != MASTER) {
+        return 0;
+    }
+    // Open the profile for the reading by the tiles, the observer has to be at its begin
+    int file;
+    profile_header_t header;
+    const char *error = open_profile_stream(settings->input, &file, &header);
+    if (error) {
+        report_error(error, layout->world_rank);
+        return 1;
+    }
+    if (!header.count || header.observer) {
+        report_error("the tiled processing needs the observer at the first altitude", layout->world_rank);
+        close(file);
+        return 1;
+    }
+
+    // The tile consists of the whole words of the results, thus the raw results of the tiles are contiguous
+    uint64_t total = header.count;
+    size_t tile = RESULT_WORDS(settings->tile) * WORD_BITS;
+    // Two buffers of the altitudes alternate between the reading and the sweeping
+    std::vector<int> buffers[2] = {std::vector<int>(tile), std::vector<int>(tile)};
+    std::vector<uint64_t> result(RESULT_WORDS(tile));
+    // Asynchronous reading of the tile starting at the given altitude to the given buffer
+    auto read_tile = [&](int buffer, uint64_t first) {
+        return std::async(
+                std::launch::async, read_profile_altitudes, file, first, std::min((uint64_t) tile, total - first),
+                buffers[buffer].data()
+        );
+    };
+    std::future<bool> pending = read_tile(0, 0);
+    int observer_altitude = 0;
+    wide_slope_t running = WIDE_SLOPE_MIN;
+    for (uint64_t first = 0, buffer = 0; first < total; first += tile, buffer ^= 1) {
+        size_t count = std::min((uint64_t) tile, total - first);
+        // Wait for the current tile and start the reading of the next one to the other buffer
+        if (!pending.get()) {
+            error = "cannot read the profile";
+            break;
+        }
+        if (first + count < total) {
+            pending = read_tile(buffer ^ 1, first + count);
+        }
+        // The altitude of the observer is the first altitude of the first tile
+        const int *altitudes = buffers[buffer].data();
+        if (!first) {
+            observer_altitude = altitudes[0];
+        }
+        // Sweep the tile from the running maximum of all preceding tiles
+        std::fill(result.begin(), result.end(), 0);
+        running = sweep_tile(altitudes, observer_altitude, first, count, running, result.data());
+        // Write out the results of the tile, the following tiles continue the same output
+        bool written = (settings->output == OUTPUT_RAW) ?
+                       write_raw(stdout, result.data(), count) :
+                       write_text_range(stdout, result.data(), first, count, total, 0);
+        if (!written) {
+            error = "cannot write out the results";
+            break;
+        }
+    }
+    // The interrupted processing still waits for the reading of the next tile before the closing of the file
+    if (pending.valid()) {
+        pending.wait();
+    }
+    close(file);
+    if (error) {
+        report_error(error, layout->world_rank);
+        return 1;
+    }
+    return 0;
+}
@@ -5,7 +5,7 @@
  * Faculty: 	Faculty of Information Technology
  * Course:	    Parallel and Distributed Algorithms
  * Date:		04.04.2020
- * Last change:	08.04.2020
+ * Last change:	17.10.2026
  *
  * Subscribe:	The main module of the program implementing Line-of-Sight problem.
  *
@@ -14,103 +14,664 @@
 /**
  * @file    vid.cpp
  * @brief   This module contains the implementation of the problem Line-of-Sight
- *          in its parallel version with use the max-prescan operation.
+ *          in its parallel version with use the max-prescan operation. The angles
+ *          are represented by the exact slopes (see kernel.h), which preserve the
+ *          ordering of the angles without the computation of the arctan.
  */
 
 
 #include "vid.h"
 
 
-void load_line_of_sight(char *input_altitudes, std::vector<int> *target_altitudes) {
-    // Break input line of sight into a series of tokens using the delimiter ',' - individual altitudes
-    char *point = strtok(input_altitudes, ",");
-    // Store the first altitude to the given vector of altitudes
-    (*target_altitudes).push_back(atoi(point));
-    // Walk through other altitudes from the input sequence
-    while (point) {
-        // Obtain the next one altitude or the NULL when the all altitudes was loaded
-        point = strtok(NULL, ",");
-        // When there is the newly altitude, then store it to the given vector of altitudes
-        if (point) {
-            (*target_altitudes).push_back(atoi(point));
+void load_line_of_sight(const text_t *text, std::vector<int> *target_altitudes) {
+    // Count all altitudes of the line of sight to allocate the vector at once
+    target_altitudes->resize(count_altitudes(text->data, text->length, 0, text->length));
+    // Parse all altitudes of the line of sight to the given vector of altitudes
+    parse_altitudes(text->data, text->length, 0, 0, target_altitudes->size(), target_altitudes->data());
+}
+
+bool parse_arguments(int argc, char **argv, settings_t *settings) {
+    // Definition of the long options of the program
+    static const struct option long_options[] = {
+            {"scan", required_argument, nullptr, 's'},
+            {"input", required_argument, nullptr, 'i'},
+            {"text", required_argument, nullptr, 't'},
+            {"write-profile", required_argument, nullptr, 'w'},
+            {"fused", no_argument, nullptr, 'f'},
+            {"output", required_argument, nullptr, 'o'},
+            {"server", no_argument, nullptr, 'S'},
+            {"socket", required_argument, nullptr, 'u'},
+            {"observer", required_argument, nullptr, 'x'},
+            {"incremental", no_argument, nullptr, 'I'},
+            {"grid", required_argument, nullptr, 'g'},
+            {"model", required_argument, nullptr, 'm'},
+            {"calibrate", no_argument, nullptr, 'C'},
+            {"tiled", required_argument, nullptr, 'T'},
+            {"benchmark", required_argument, nullptr, 'b'},
+            {"telemetry", no_argument, nullptr, 'r'},
+            {"trace", required_argument, nullptr, 'R'},
+            {"element", required_argument, nullptr, 'e'},
+            {"placement", required_argument, nullptr, 'P'},
+            {"observers", required_argument, nullptr, 'X'},
+            {"summary", required_argument, nullptr, 'q'},
+            {nullptr, 0, nullptr, 0}
+    };
+    // Set the default settings of the program
+    settings->line_of_sight = settings->input = settings->text = settings->write_profile = nullptr;
+    settings->scan = SCAN_TREE;
+    settings->fused = false;
+    settings->output = OUTPUT_TEXT;
+    settings->server = false;
+    settings->socket = nullptr;
+    settings->incremental = false;
+    settings->observer = -1;
+    settings->observers = nullptr;
+    settings->grid_width = 0;
+    settings->model = cost_model_t{COST_POINT, COST_SYNC};
+    settings->calibrate = false;
+    settings->tile = 0;
+    settings->benchmark = 0;
+    settings->telemetry = false;
+    settings->trace = nullptr;
+    settings->element_type = PROFILE_INT32;
+    settings->placement = PLACEMENT_DEFAULT;
+    settings->summary = SUMMARY_NONE;
+    settings->horizon_step = HORIZON_STEP;
+    // Errors are reported only by the master process by the usage of the program
+    opterr = 0;
+    // Walk through all options given on the command line
+    int option;
+    while ((option = getopt_long(argc, argv, "s:i:t:w:fo:Su:x:Ig:m:CT:b:rR:e:P:X:q:", long_options, nullptr)) != -1) {
+        switch (option) {
+            // Engine performing the max-prescan of the processor maximums
+            case 's':
+                if (!strcmp(optarg, "tree")) {
+                    settings->scan = SCAN_TREE;
+                } else if (!strcmp(optarg, "lookback")) {
+                    settings->scan = SCAN_LOOKBACK;
+                } else {
+                    return false;
+                }
+                break;
+            // Binary profile used instead of the line of sight
+            case 'i':
+                settings->input = optarg;
+                break;
+            // File with the line of sight used instead of the line of sight on the command line
+            case 't':
+                settings->text = optarg;
+                break;
+            // Binary profile to write the line of sight to
+            case 'w':
+                settings->write_profile = optarg;
+                break;
+            // Fused pipeline computing the results directly from the altitudes
+            case 'f':
+                settings->fused = true;
+                break;
+            // Format of the written results
+            case 'o':
+                if (!strcmp(optarg, "text")) {
+                    settings->output = OUTPUT_TEXT;
+                } else if (!strcmp(optarg, "raw")) {
+                    settings->output = OUTPUT_RAW;
+                } else if (!strcmp(optarg, "rle")) {
+                    settings->output = OUTPUT_RLE;
+                } else {
+                    return false;
+                }
+                break;
+            // Server reading the lines of sight from the standard input
+            case 'S':
+                settings->server = true;
+                break;
+            // Server reading the lines of sight from the clients of the local socket
+            case 'u':
+                settings->server = true;
+                settings->socket = optarg;
+                break;
+            // Server keeping one line of sight changed by the commands of the requests
+            case 'I':
+                settings->server = true;
+                settings->incremental = true;
+                break;
+            // Index of the altitude, where the observer is placed
+            case 'x': {
+                char *end;
+                settings->observer = strtoll(optarg, &end, 10);
+                if (*end || settings->observer < 0) {
+                    return false;
+                }
+                break;
+            }
+            // Width of the grid of the viewshed stored within the binary profile
+            case 'g': {
+                char *end;
+                settings->grid_width = strtoll(optarg, &end, 10);
+                if (*end || settings->grid_width <= 0) {
+                    return false;
+                }
+                break;
+            }
+            // Cost model of the machine in the format POINT,SYNC (nanoseconds)
+            case 'm': {
+                char *end;
+                settings->model.point = strtod(optarg, &end);
+                if (*end != ',') {
+                    return false;
+                }
+                settings->model.sync = strtod(end + 1, &end);
+                if (*end || settings->model.point < 0 || settings->model.sync < 0) {
+                    return false;
+                }
+                break;
+            }
+            // Measurement of the cost model of the machine
+            case 'C':
+                settings->calibrate = true;
+                break;
+            // Out-of-core processing by the tiles of the given number of the altitudes
+            case 'T': {
+                char *end;
+                settings->tile = strtoll(optarg, &end, 10);
+                if (*end || settings->tile <= 0 || settings->tile > INT_MAX) {
+                    return false;
+                }
+                break;
+            }
+            // Benchmark of the pipeline with the given number of the repetitions
+            case 'b': {
+                char *end;
+                long repetitions = strtol(optarg, &end, 10);
+                if (*end || repetitions <= 0 || repetitions > INT_MAX) {
+                    return false;
+                }
+                settings->benchmark = repetitions;
+                break;
+            }
+            // Telemetry of the phases of the processes written out as the table
+            case 'r':
+                settings->telemetry = true;
+                break;
+            // Telemetry of the phases of the processes written out as the trace file
+            case 'R':
+                settings->trace = optarg;
+                break;
+            // Element type of the altitudes of the written binary profile
+            case 'e':
+                if (!strcmp(optarg, "int32")) {
+                    settings->element_type = PROFILE_INT32;
+                } else if (!strcmp(optarg, "int16")) {
+                    settings->element_type = PROFILE_INT16;
+                } else {
+                    return false;
+                }
+                break;
+            // Placement of the pages of the shared windows
+            case 'P':
+                if (!strcmp(optarg, "local")) {
+                    settings->placement = PLACEMENT_LOCAL;
+                } else if (!strcmp(optarg, "huge")) {
+                    settings->placement = PLACEMENT_HUGE;
+                } else {
+                    return false;
+                }
+                break;
+            // Indices of the observers of the batch
+            case 'X': {
+                std::vector<long long> observers;
+                if (!parse_observers(optarg, &observers)) {
+                    return false;
+                }
+                settings->observers = optarg;
+                break;
+            }
+            // Summary written out instead of the results of all points
+            case 'q':
+                if (!parse_summary(optarg, settings)) {
+                    return false;
+                }
+                break;
+            // Unknown option or missing argument of the option
+            default:
+                return false;
+        }
+    }
+    // The element type is chosen only for the written binary profile, the read one stores its own
+    if (settings->element_type != PROFILE_INT32 && !settings->write_profile) {
+        return false;
+    }
+    // The telemetry records only the pipeline solving the one line of sight
+    if ((settings->telemetry || settings->trace) &&
+        (settings->calibrate || settings->benchmark || settings->tile || settings->grid_width || settings->server ||
+         settings->write_profile)) {
+        return false;
+    }
+    // The placement is chosen only for the windows of the pipeline solving the one line of sight
+    if (settings->placement != PLACEMENT_DEFAULT &&
+        (settings->calibrate || settings->tile || settings->grid_width || settings->server || settings->write_profile)) {
+        return false;
+    }
+    // The batch replaces the single observer, its results are the counts or the bitsets of the observers
+    if (settings->observers &&
+        (settings->observer >= 0 || settings->output == OUTPUT_RLE || settings->calibrate || settings->benchmark ||
+         settings->tile || settings->grid_width || settings->server || settings->write_profile ||
+         settings->telemetry || settings->trace)) {
+        return false;
+    }
+    // The summary replaces the output format of the results of the pipeline solving the one line of sight, the
+    // horizon is read from the stored angles, which the fused pipeline (and the observer inside) does not keep
+    if (settings->summary != SUMMARY_NONE &&
+        (settings->output != OUTPUT_TEXT || settings->calibrate || settings->benchmark || settings->tile ||
+         settings->grid_width || settings->server || settings->write_profile || settings->observers ||
+         (settings->summary == SUMMARY_HORIZON && (settings->fused || settings->observer > 0)))) {
+        return false;
+    }
+    // The calibration and the benchmark need no input, they generate their own data
+    if (settings->calibrate || settings->benchmark) {
+        return optind == argc;
+    }
+    // The tiled processing streams the binary profile from the first altitude
+    if (settings->tile) {
+        return optind == argc && settings->input && !settings->server && !settings->grid_width &&
+               settings->output != OUTPUT_RLE && settings->observer <= 0;
+    }
+    // The viewshed is computed over the grid stored within the binary profile, it is written out as the raster
+    if (settings->grid_width) {
+        return optind == argc && settings->input && !settings->server && settings->output != OUTPUT_RLE;
+    }
+    // The server reads the lines of sight from its stream, the responses are delimited by the new lines
+    if (settings->server) {
+        return optind == argc && !settings->input && !settings->text && !settings->write_profile &&
+               settings->output != OUTPUT_RAW && settings->observer < 0;
+    }
+    // The binary profile replaces the line of sight and it cannot be written again
+    if (settings->input) {
+        return optind == argc && !settings->text && !settings->write_profile;
+    }
+    // The file with the line of sight replaces the positional argument
+    if (settings->text) {
+        return optind == argc;
+    }
+    // The line of sight is the only positional argument
+    if (optind != argc - 1) {
+        return false;
+    }
+    settings->line_of_sight = argv[optind];
+    return true;
+}
+
+void report_error(const char *message, int world_rank) {
+    // Only the master process writes out the error, all processes have the same one
+    if (world_rank == MASTER) {
+        std::cerr << "vid: " << message << std::endl;
+    }
+}
+
+void split_to_nodes(layout_t *layout) {
+    // Determines the rank of the calling process in the communicator of the participating processes
+    MPI_Comm_rank(layout->comm, &layout->world_rank);
+    // Split the processes to the nodes, where the processes of each node are able to create the shared memory
+    MPI_Comm_split_type(
+            layout->comm, MPI_COMM_TYPE_SHARED, layout->world_rank, MPI_INFO_NULL, &layout->node_comm
+    );
+    // Returns the size of the group associated with a node communicator
+    MPI_Comm_size(layout->node_comm, &layout->size);
+    // Determines the rank of the calling process in the node communicator
+    MPI_Comm_rank(layout->node_comm, &layout->rank);
+    // The master processes of the nodes create the inter-node communicator ordered by their world ranks
+    MPI_Comm_split(
+            layout->comm, (layout->rank == MASTER) ? 0 : MPI_UNDEFINED, layout->world_rank, &layout->leaders_comm
+    );
+    // Node information (number of the nodes, index of the node and position of the first process of the node)
+    int node_info[3] = {1, 0, 0};
+    if (layout->rank == MASTER) {
+        // Returns the number of the nodes and the index of the node of the calling master process
+        MPI_Comm_size(layout->leaders_comm, &node_info[0]);
+        MPI_Comm_rank(layout->leaders_comm, &node_info[1]);
+        // The position of the first process of the node is the number of the processes on the preceding nodes
+        MPI_Exscan(&layout->size, &node_info[2], COUNT, MPI_INT, MPI_SUM, layout->leaders_comm);
+        // The result of the exclusive scan is undefined on the first node
+        if (node_info[1] == MASTER) {
+            node_info[2] = 0;
         }
     }
+    // Broadcast the node information from the master of the node to all other processes of the node
+    MPI_Bcast(node_info, 3, MPI_INT, MASTER, layout->node_comm);
+    layout->nodes = node_info[0];
+    layout->node = node_info[1];
+    layout->node_position = node_info[2];
+}
+
+int partition_points(int total_altitudes, int processes, int position, size_t unit) {
+    // The altitudes are distributed by the whole units (the whole words of the bitset of the results)
+    long long units = (total_altitudes + (long long) unit - 1) / unit;
+    // The preceding processes have u/p units and the first (u mod p) processes one unit more
+    long long first_unit = position * (units / processes) + std::min((long long) position, units % processes);
+    // The last unit may be only partially used
+    return std::min((long long) total_altitudes, first_unit * (long long) unit);
+}
+
+void *query_node_base(MPI_Win win, size_t alignment) {
+    // Auxiliary variables to query at shared memory without the change of the window of the process
+    MPI_Aint master_window_size;
+    int disp_unit;
+    char *base;
+    // Query the aligned base pointer of the node part of a shared memory window of the master process
+    telemetry_shared_query(win, MASTER, &master_window_size, &disp_unit, &base);
+    // The processes map the window at the addresses equal only modulo the page, thus the base is aligned at most
+    // to the page, otherwise the processes would see the node part at different offsets
+    alignment = std::min(alignment, (size_t) PAGE_ALIGN);
+    // The node part starts at the first aligned address, the MPI library aligns the window only to the words
+    return (void *) (((uintptr_t) base + alignment - 1) & ~(uintptr_t) (alignment - 1));
+}
+
+void *allocate_node_window(size_t count, size_t unit, size_t first, size_t own, const layout_t *layout, MPI_Win *win) {
+    // Only the master process of the node allocates the memory with the padding to the aligned base
+    MPI_Aint size = (layout->rank == MASTER) ? count * unit + std::min(layout->alignment, (size_t) PAGE_ALIGN) : 0;
+    char *base;
+    // Create an window for one-sided communication and shared memory access, and allocate memory at the master process
+    MPI_Win_allocate_shared(size, unit, MPI_INFO_NULL, layout->node_comm, &base, win);
+    base = (char *) query_node_base(*win, layout->alignment);
+    // The default placement leaves the pages to the MPI library and to the first write of the pipeline
+    if (layout->placement == PLACEMENT_DEFAULT || !own) {
+        return base;
+    }
+    // The huge pages are only advised, the window stays usable, when the kernel does not back it by them
+    if (layout->placement == PLACEMENT_HUGE) {
+        madvise(base, count * unit, MADV_HUGEPAGE);
+    }
+    // Each process touches its own part first, thus the kernel places its pages on the NUMA node of the process
+    memset(base + first * unit, 0, own * unit);
+    return base;
+}
+
+void gather_node_parts(std::vector<int> *counts, std::vector<int> *displacements, const layout_t *layout) {
+    // Master process prepares the vectors for the values of all nodes
+    if (layout->world_rank == MASTER) {
+        counts->resize(layout->nodes);
+        displacements->resize(layout->nodes);
+    }
+    // Gather the number of the altitudes stored on each node
+    MPI_Gather(&layout->node_count, COUNT, MPI_INT, counts->data(), COUNT, MPI_INT, MASTER, layout->leaders_comm);
+    // Gather the indices of the first altitudes stored on each node
+    MPI_Gather(
+            &layout->node_first, COUNT, MPI_INT, displacements->data(), COUNT, MPI_INT, MASTER, layout->leaders_comm
+    );
+}
+
+void slope_max_operation(void *in, void *inout, int *len, MPI_Datatype *) {
+    // inout[i] = max(in[i], inout[i]) for each element of the vectors
+    for (int i = 0; i < *len; i++) {
+        ((slope_t *) inout)[i] = slope_max(((slope_t *) in)[i], ((slope_t *) inout)[i]);
+    }
+}
+
+void assign_points_to_process(layout_t *layout) {
+    // Returns the number of all processes
+    int processes;
+    MPI_Comm_size(layout->comm, &processes);
+    // Number of the altitudes, by which the parts of the processes start at the aligned addresses
+    size_t unit = ALIGN_POINTS(layout->alignment);
+    // Compute the part of the altitudes stored on the node - the parts of all processes of the node
+    layout->node_first = partition_points(layout->total_altitudes, processes, layout->node_position, unit);
+    layout->node_count =
+            partition_points(layout->total_altitudes, processes, layout->node_position + layout->size, unit) -
+            layout->node_first;
+    // Compute the start index of the process window within the node part
+    layout->start_idx =
+            partition_points(layout->total_altitudes, processes, layout->node_position + layout->rank, unit) -
+            layout->node_first;
+    // Define the final size of the window for each process to each shared memory
+    layout->window_size =
+            partition_points(layout->total_altitudes, processes, layout->node_position + layout->rank + 1, unit) -
+            layout->node_first - layout->start_idx;
+}
+
+bool open_line_of_sight(const settings_t *settings, text_t *text, int world_rank) {
+    // The line of sight given on the command line is available to all processes without any mapping
+    if (!settings->text) {
+        text->mapping = nullptr;
+        text->data = settings->line_of_sight;
+        text->length = strlen(settings->line_of_sight);
+        return true;
+    }
+    // Each process maps the file itself, the mapped pages are shared by the processes on the same node
+    const char *error = open_text(settings->text, text);
+    // The file is used only when all processes mapped it
+    int mapped = !error;
+    MPI_Allreduce(MPI_IN_PLACE, &mapped, COUNT, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (!mapped) {
+        report_error(error ? error : "cannot map the line of sight on all processes", world_rank);
+        close_text(text);
+    }
+    return mapped;
+}
+
+bool count_points_to_process(
+    const text_t *text, std::vector<long long> *firsts, int *observer_altitude, layout_t *layout
+) {
+    // Returns the number of all processes and the position of the process within their sequence
+    int processes, position = layout->node_position + layout->rank;
+    MPI_Comm_size(layout->comm, &processes);
+    // Each process counts the altitudes starting within its equal byte range of the text
+    long long own_count[2] = {
+            position, (long long) count_altitudes(
+                    text->data, text->length, text->length * position / processes,
+                    text->length * (position + 1) / processes
+            )
+    };
+    // All processes obtain the counts of all byte ranges, since the altitudes are partitioned by their indices
+    std::vector<long long> counts(2 * processes);
+    MPI_Allgather(own_count, 2, MPI_LONG_LONG, counts.data(), 2, MPI_LONG_LONG, layout->comm);
+    // firsts[r] = index of the first altitude starting within the byte range r (exclusive prefix sum of the counts)
+    firsts->assign(processes + 1, 0);
+    for (int i = 0; i < processes; i++) {
+        (*firsts)[counts[2 * i] + 1] = counts[2 * i + 1];
+    }
+    for (int i = 0; i < processes; i++) {
+        (*firsts)[i + 1] += (*firsts)[i];
+    }
+    if (!(*firsts)[processes] || (*firsts)[processes] > INT_MAX) {
+        return false;
+    }
+    // Assign the relevant number of altitudes for each process
+    layout->total_altitudes = (*firsts)[processes];
+    assign_points_to_process(layout);
+    // The altitude of the observer is the first altitude of the text
+    parse_altitudes(text->data, text->length, 0, 0, COUNT, observer_altitude);
+    return true;
+}
+
+void parse_points_to_process(
+    int *shared_altitudes, const text_t *text, const std::vector<long long> *firsts, const layout_t *layout
+) {
+    // Number of the byte ranges counted before, the processes parsing the text may be fewer than them
+    int processes = firsts->size() - 1;
+    // Each process parses its own part of the altitudes directly to the shared memory of the node
+    if (layout->window_size) {
+        // Find the byte range, within which the first altitude of the process starts
+        long long first = layout->node_first + layout->start_idx;
+        int range = std::upper_bound(firsts->begin(), firsts->end(), first) - firsts->begin() - 1;
+        // Skip the preceding altitudes of the range and parse the altitudes of the process window
+        parse_altitudes(
+                text->data, text->length, text->length * range / processes, first - (*firsts)[range],
+                layout->window_size, shared_altitudes + layout->start_idx
+        );
+    }
+    // Blocks until all processes of the node have parsed own part of the altitudes
+    telemetry_barrier(layout->node_comm);
 }
 
 void share_points_to_process(
-    int **shared_altitudes, MPI_Win *node_altitudes, MPI_Aint *window_size, int total_altitudes, int size,
-    std::vector<int> altitudes, int rank
+    int **shared_altitudes, MPI_Win *node_altitudes, const text_t *text, const std::vector<long long> *firsts,
+    const layout_t *layout
 ) {
-    // Compute the number of altitudes per each processor - equal number for each processor
-    int points_per_processors = floor(total_altitudes / size);
-    // Define the final size of the window for each process to each shared memory
-    *window_size = (rank < (total_altitudes % size)) ? points_per_processors + 1 : points_per_processors;
-    // Create an window for one-sided communication and shared memory access, and allocate memory at each process
-    // Allocate shared window to store the loaded angles.
-    MPI_Win_allocate_shared(
-            (*window_size) * INT_UNIT, INT_UNIT, MPI_INFO_NULL, MPI_COMM_WORLD, &(*shared_altitudes), &(*node_altitudes)
+    // Allocate shared window to store the loaded altitudes, each process places the pages of its own part
+    *shared_altitudes = (int *) allocate_node_window(
+            layout->node_count, INT_UNIT, layout->start_idx, layout->window_size, layout, node_altitudes
     );
-    // Master process copy the angles vector to the allocate shared memory for each process
-    if (rank == MASTER) {
-        std::copy(altitudes.begin(), altitudes.end(), *shared_altitudes);
+    // Each process parses its own part of the altitudes directly to the shared memory of the node
+    parse_points_to_process(*shared_altitudes, text, firsts, layout);
+}
+
+int schedule_processes(long long total_altitudes, int processes, const cost_model_t *model) {
+    // The single process sweeps all altitudes sequentially without any synchronisation
+    int best = 1;
+    double best_cost = total_altitudes * model->point;
+    for (int p = 2; p <= processes; p++) {
+        // The processes share the altitudes, but each level of the max-prescan tree synchronises all of them
+        int levels = 0;
+        while ((1 << levels) < p) {
+            levels++;
+        }
+        double cost = (double) total_altitudes / p * model->point + (2 * levels + COST_STAGES) * model->sync;
+        // The equal costs prefer the more processes, the zero model thus keeps all of them
+        if (cost <= best_cost) {
+            best = p;
+            best_cost = cost;
+        }
     }
+    return best;
 }
 
+bool park_processes(int active, layout_t *layout) {
+    // Returns the number of the currently participating processes
+    int processes;
+    MPI_Comm_size(layout->comm, &processes);
+    if (active >= processes) {
+        return true;
+    }
+    // The communicators of the nodes are created again only for the participating processes
+    if (layout->leaders_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&layout->leaders_comm);
+    }
+    MPI_Comm_free(&layout->node_comm);
+    // The processes with the lowest ranks participate, they thus occupy the least number of the nodes
+    MPI_Comm comm;
+    MPI_Comm_split(
+            layout->comm, (layout->world_rank < active) ? 0 : MPI_UNDEFINED, layout->world_rank, &comm
+    );
+    if (comm == MPI_COMM_NULL) {
+        return false;
+    }
+    layout->comm = comm;
+    split_to_nodes(layout);
+    return true;
+}
+
+void calibrate_cost_model(cost_model_t *model, const layout_t *layout) {
+    // Returns the number of all processes
+    int processes;
+    MPI_Comm_size(layout->comm, &processes);
+    // Master process measures the sweep of the pseudo-random altitudes
+    if (layout->world_rank == MASTER) {
+        std::vector<int> altitudes(CALIBRATION_POINTS);
+        std::vector<uint64_t> result(RESULT_WORDS(CALIBRATION_POINTS));
+        unsigned int seed = 1;
+        for (int &altitude : altitudes) {
+            seed = seed * 1103515245 + 12345;
+            altitude = (seed >> 16) % 10000;
+        }
+        double start = MPI_Wtime();
+        sweep_slopes(altitudes.data(), altitudes[0], 0, CALIBRATION_POINTS, SLOPE_MIN, result.data(), 0);
+        model->point = (MPI_Wtime() - start) * 1e9 / CALIBRATION_POINTS;
+    }
+    // All processes measure the barriers, the first one only synchronises the start
+    MPI_Barrier(layout->comm);
+    double start = MPI_Wtime();
+    for (int i = 0; i < CALIBRATION_BARRIERS; i++) {
+        MPI_Barrier(layout->comm);
+    }
+    int levels = 1;
+    while ((1 << levels) < processes) {
+        levels++;
+    }
+    model->sync = (MPI_Wtime() - start) * 1e9 / CALIBRATION_BARRIERS / levels;
+}
+
+bool map_profile(const char *path, profile_t *profile, int *observer_altitude, layout_t *layout) {
+    // Each process maps the profile itself, the mapped pages are shared by the processes on the same node
+    const char *error = open_profile(path, profile);
+    // The profile is used only when all processes mapped it
+    int mapped = !error;
+    MPI_Allreduce(MPI_IN_PLACE, &mapped, COUNT, MPI_INT, MPI_MIN, layout->comm);
+    if (!mapped) {
+        report_error(error ? error : "cannot map the profile on all processes", layout->world_rank);
+    } else if (!profile->header->count || profile->header->count > INT_MAX) {
+        report_error("unsupported number of the altitudes in the profile", layout->world_rank);
+    } else {
+        // Save the number of the altitudes, the place of the observer and its altitude from the profile
+        layout->total_altitudes = profile->header->count;
+        layout->observer = profile->header->observer;
+        *observer_altitude = profile_altitude(profile, profile->header->observer);
+        return true;
+    }
+    // Unmap the profile, which will not be used
+    if (error == nullptr) {
+        close_profile(profile);
+    }
+    return false;
+}
+
+template <typename altitude_t>
 void compute_angles(
-    int **shared_altitudes, float **shared_angles, float **max_previous_angles, MPI_Win node_altitudes, MPI_Win
-    node_angles, MPI_Win node_prev_angles, MPI_Aint window_size, int disp_unit, int total_altitudes, int size, int rank
+    const altitude_t *altitudes, slope_t **shared_angles, slope_t **max_previous_angles, MPI_Win node_angles,
+    MPI_Win node_prev_angles, int observer_altitude, const layout_t *layout
 ) {
-    // Declare auxiliary window size to query at shared memory without the change relevant window size of processes
-    MPI_Aint master_window_size;
-    // Compute the start index for each process within the shared memory with respect to the common begin
-    int start_idx = (rank < total_altitudes % size) ? rank * window_size : rank * window_size + (total_altitudes % size);
-    // Query the size and base pointer for a patch of a shared memory window with shared altitudes
-    MPI_Win_shared_query(node_altitudes, MASTER, &master_window_size, &disp_unit, &(*shared_altitudes));
-    // Query the size and base pointer for a patch of a shared memory window with shared angles
-    MPI_Win_shared_query(node_angles, MASTER, &master_window_size, &disp_unit, &(*shared_angles));
-    // Query the size and base pointer for a patch of a shared memory window with maximum previous angles (max-prescan)
-    MPI_Win_shared_query(node_prev_angles, MASTER, &master_window_size, &disp_unit, &(*max_previous_angles));
+    // Start index of the process within the shared memory with respect to the common begin of the node
+    int start_idx = layout->start_idx;
+    // Query the aligned base pointer of the node part of a shared memory window with shared angles
+    *shared_angles = (slope_t *) query_node_base(node_angles, layout->alignment);
+    // Query the aligned base pointer of the node part of a shared memory window with maximum previous angles
+    *max_previous_angles = (slope_t *) query_node_base(node_prev_angles, layout->alignment);
     // Each process compute own n/p sub-part of the whole angles and store them to the relevant index
-    for (size_t i = start_idx; i < start_idx + window_size; i++) {
-        // angle[i] = arctan( (altitude[i] - altitude[0]) / i ); neutral item for i=0
-        (*shared_angles)[i] = (*max_previous_angles)[i] =
-                (i) ? atan(((*shared_altitudes)[i] - (*shared_altitudes)[0]) / float(i)) : FLOAT_MIN;
-    }
+    // angle[i] = (altitude[i] - altitude[0]) / i; neutral item for i=0
+    compute_slopes(
+            altitudes + start_idx, observer_altitude, layout->node_first + start_idx, layout->window_size,
+            *shared_angles + start_idx
+    );
+    // Copy the computed angles as the input of the max-prescan operation
+    std::copy(
+            *shared_angles + start_idx, *shared_angles + start_idx + layout->window_size,
+            *max_previous_angles + start_idx
+    );
     // Blocks until all processes in the communicator have computed own part of the angles
-    MPI_Barrier(MPI_COMM_WORLD);
+    telemetry_barrier(layout->node_comm);
 }
 
 void max_prescan(
-    float **shared_angles, MPI_Win node_angles, MPI_Aint window_size, int disp_unit, int total_angles, int size, int rank
+    slope_t **shared_angles, MPI_Win node_angles, slope_t identity, int stride, int total_angles, int rank,
+    const layout_t *layout
 ) {
-    // Declare auxiliary window size to query at shared memory without the change relevant window size of processes
-    MPI_Aint master_window_size;
+    // Element of the vector at the given index, the consecutive elements are the given number of the slopes apart
+    auto node = [&](long long index) -> slope_t & { return (*shared_angles)[index * stride]; };
     // Up-Sweep phase of the max-prescan operation
     // for d from 0 to (lg n) - 1
     for (size_t d = 0; d < ceil(log2(total_angles)); d++) {
         // in parallel for i from 0 to n-1 by 2^(d+1)
         if (!(rank % (1 << (d)))) {
-            // Query the size and base pointer for a patch of a shared memory window with shared angles
-            MPI_Win_shared_query(node_angles, MASTER, &master_window_size, &disp_unit, &(*shared_angles));
-            // Obtain the value angles[i + 2(d) - 1] if there exists, otherwise replace value by FLOAT_MIN in 1.iter
-            float left_node = (rank * 2 + (1 << (d)) - 1 >= total_angles and d == 0) ?
-                              FLOAT_MIN : (*shared_angles)[rank * 2 + (1 << (d)) - 1];
-            // Obtain the value angles[i + 2(d+1) - 1] if there exists, otherwise replace value by FLOAT_MIN in 1.iter
-            float right_node = (rank * 2 + (1 << (d + 1)) - 1 >= total_angles and d == 0) ?
-                               FLOAT_MIN : (*shared_angles)[rank * 2 + (1 << (d + 1)) - 1];
+            // Query the aligned base pointer of the node part of a shared memory window with shared angles
+            *shared_angles = (slope_t *) query_node_base(node_angles, layout->alignment);
+            // Obtain the value angles[i + 2(d) - 1] if there exists, otherwise replace value by SLOPE_MIN in 1.iter
+            slope_t left_node = (rank * 2 + (1 << (d)) - 1 >= total_angles and d == 0) ?
+                                SLOPE_MIN : node(rank * 2 + (1 << (d)) - 1);
+            // Obtain the value angles[i + 2(d+1) - 1] if there exists, otherwise replace value by SLOPE_MIN in 1.iter
+            slope_t right_node = (rank * 2 + (1 << (d + 1)) - 1 >= total_angles and d == 0) ?
+                                 SLOPE_MIN : node(rank * 2 + (1 << (d + 1)) - 1);
             // angles[i + 2(d+1) - 1] = max(angles[i + 2(d) - 1], angles[i + 2(d+1) - 1])
-            (*shared_angles)[rank * 2 + (1 << (d + 1)) - 1] = std::max(left_node, right_node);
+            node(rank * 2 + (1 << (d + 1)) - 1) = slope_max(left_node, right_node);
         }
         // Blocks until relevant processes in the iteration have computed the required results for the next iteration
-        MPI_Barrier(MPI_COMM_WORLD);
+        telemetry_barrier(layout->node_comm);
     }
 
-    // Master process sets the identity to the root to the root of the tree before the down-sweep phase
+    // Master process sets the identity to the root of the tree before the down-sweep phase
     if (rank == MASTER) {
-        // Query the size and base pointer for a patch of a shared memory window with shared angles
-        MPI_Win_shared_query(node_angles, MASTER, &master_window_size, &disp_unit, &(*shared_angles));
-        // angles[n - 1] = FLOAT_MIN (I); set the neutral item to the root of the tree
-        (*shared_angles)[NEXT_POWER_2(total_angles) - 1] = FLOAT_MIN;
+        // Query the aligned base pointer of the node part of a shared memory window with shared angles
+        *shared_angles = (slope_t *) query_node_base(node_angles, layout->alignment);
+        // angles[n - 1] = I; set the neutral item (or the offset of the preceding nodes) to the root of the tree
+        node(NEXT_POWER_2(total_angles) - 1) = identity;
     }
 
     // Down-Sweep phase of the max-prescan operation
@@ -118,130 +679,525 @@ void max_prescan(
     for (int d = ceil(log2(total_angles)) - 1; d >= 0; d--) {
         // in parallel for i from 0 to n-1 by 2^(d+1)
         if (!(rank % (1 << (d)))) {
-            // Query the size and base pointer for a patch of a shared memory window with shared angles
-            MPI_Win_shared_query(node_angles, MASTER, &master_window_size, &disp_unit, &(*shared_angles));
+            // Query the aligned base pointer of the node part of a shared memory window with shared angles
+            *shared_angles = (slope_t *) query_node_base(node_angles, layout->alignment);
             // Save the temporary - t = angles[i + 2^(d) - 1]
-            float tmp = (*shared_angles)[rank * 2 + (1 << (d)) - 1];
+            slope_t tmp = node(rank * 2 + (1 << (d)) - 1);
             // Set the left child - angles[i + 2^(d) - 1] = angles[i + 2^(d+1) - 1]
-            (*shared_angles)[rank * 2 + (1 << (d)) - 1] = (*shared_angles)[rank * 2 + (1 << (d + 1)) - 1];
+            node(rank * 2 + (1 << (d)) - 1) = node(rank * 2 + (1 << (d + 1)) - 1);
             // Set the left child - angles[i + 2^(d+1) - 1] = max(t, angles[i + 2^(d+1) - 1])
-            (*shared_angles)[rank * 2 + (1 << (d + 1)) - 1] =
-                    std::max(tmp, (*shared_angles)[rank * 2 + (1 << (d + 1)) - 1]);
+            node(rank * 2 + (1 << (d + 1)) - 1) = slope_max(tmp, node(rank * 2 + (1 << (d + 1)) - 1));
         }
         // Blocks until relevant processes in the iteration have computed the required results for the next iteration
-        MPI_Barrier(MPI_COMM_WORLD);
+        telemetry_barrier(layout->node_comm);
     }
 }
 
-void preprocess_subsets(
-    float **shared_angles, MPI_Win node_angles, MPI_Aint window_size, int disp_unit, int total_angles, int size, int rank
-) {
-    // Define the shared pointer to allocate shared window to store the maximums of the processors
-    float *sub_max;
-    // Create an area of memory for each processors to shared allocated memory (windows within shared array)
-    MPI_Win node_sub_max;
-    // Declare auxiliary window size to query at shared memory without the change relevant window size of processes
-    MPI_Aint master_window_size;
-
-    // Create an window for one-sided communication and shared memory access, and allocate memory at each process
-    // Allocate shared window to store the maximums of the processors
-    MPI_Win_allocate_shared(FLOAT_UNIT, FLOAT_UNIT, MPI_INFO_NULL, MPI_COMM_WORLD, &sub_max, &node_sub_max);
-    // Query the size and base pointer for a patch of a shared memory window with shared angles
-    MPI_Win_shared_query(node_angles, MASTER, &master_window_size, &disp_unit, &(*shared_angles));
-    // Query the size and base pointer for a patch of a shared memory window with processors maximums
-    MPI_Win_shared_query(node_sub_max, MASTER, &master_window_size, &disp_unit, &sub_max);
-    // Compute the start index for each process within the shared memory with respect to the common begin
-    int start_idx = (rank < total_angles % size) ? rank * window_size : rank * window_size + (total_angles % size);
-    // Set the first from angle from the process window as the initial maximum
-    // max[i] = angles[(n/p) * i]
-    sub_max[rank] = (*shared_angles)[start_idx];
-    // Each processor obtain the maximum angle from the its window
-    // for j from 1 to n/p
-    for (size_t i = start_idx; i < start_idx + window_size; i++) {
-        // max[i] = max(max[i], angels[(n/p) * i + j])
-        sub_max[rank] = std::max((*shared_angles)[i], sub_max[rank]);
+slope_t node_exclusive_max(slope_t node_max, const layout_t *layout) {
+    // Maximum of all angles on the preceding nodes, the neutral element when there is only one node
+    slope_t node_offset = SLOPE_MIN;
+    if (layout->nodes > 1) {
+        // Create the operation computing the maximum of the slopes (commutative)
+        MPI_Op slope_max_op;
+        MPI_Op_create(&slope_max_operation, true, &slope_max_op);
+        // Perform the exclusive max-scan of the node maximums, only one value per node is sent
+        double waiting = telemetry_clock();
+        MPI_Exscan(&node_max, &node_offset, COUNT, MPI_2INT, slope_max_op, layout->leaders_comm);
+        telemetry_waited(waiting);
+        // The result of the exclusive scan is undefined on the first node
+        if (layout->node == MASTER) {
+            node_offset = SLOPE_MIN;
+        }
+        MPI_Op_free(&slope_max_op);
     }
+    return node_offset;
+}
 
-    // Blocks until all processes in the communicator have computed own n/p section maximum
-    MPI_Barrier(MPI_COMM_WORLD);
-    // Perform the max-prescan operation on the processor maximums - max-prescan(max)
-    max_prescan(&sub_max, node_sub_max, window_size, disp_unit, size, size, rank);
-
-    // Query the size and base pointer for a patch of a shared memory window with shared angles
-    MPI_Win_shared_query(node_angles, MASTER, &master_window_size, &disp_unit, &(*shared_angles));
-    // Query the size and base pointer for a patch of a shared memory window with result of the max-prescan operation
-    MPI_Win_shared_query(node_sub_max, MASTER, &master_window_size, &disp_unit, &sub_max);
+void prescan_window(slope_t *shared_angles, slope_t offset, const layout_t *layout) {
+    // The process without any altitude has nothing to prescan
+    if (!layout->window_size) {
+        return;
+    }
+    // Start index of the process within the shared memory with respect to the common begin of the node
+    int start_idx = layout->start_idx;
     // Temporary save of the first angle within process window
-    float prev_point = (*shared_angles)[start_idx];
+    slope_t prev_point = shared_angles[start_idx];
     // Set the maximum as offset for each process base on the results from the max-prescan operation
-    (*shared_angles)[start_idx] = sub_max[rank];
+    shared_angles[start_idx] = offset;
     // Each processor prescan self n/p section
-    for (size_t i = start_idx + 1; i < start_idx + window_size; i++) {
+    for (int i = start_idx + 1; i < start_idx + layout->window_size; i++) {
         // Save the current value of the maximum from the comparison before the rewrites temporary variable
-        float max = std::max(prev_point, (*shared_angles)[i - 1]);
+        slope_t max = slope_max(prev_point, shared_angles[i - 1]);
         // Save the current value of the angle before the rewrite it with the previous maximum value
-        prev_point = (*shared_angles)[i];
+        prev_point = shared_angles[i];
         // Set the previous maximum value to the relevant index in the shared memory
-        (*shared_angles)[i] = max;
+        shared_angles[i] = max;
     }
+}
+
+slope_t window_offset(slope_t window_max, const layout_t *layout) {
+    // Define the shared pointer to allocate shared window to store the maximums of the processors
+    slope_t *sub_max;
+    // Create an area of memory for each processors to shared allocated memory (windows within shared array)
+    MPI_Win node_sub_max;
+    // Rank and size of the process within the node
+    int rank = layout->rank, size = layout->size;
+
+    // Allocate shared window to store the maximums of the processors, each maximum occupies its own cache line,
+    // thus the processes never write to the same line, the window covers all nodes of the max-prescan tree
+    sub_max = (slope_t *) allocate_node_window(
+            PRESCAN_TAIL(size) * LINE_SLOPES, SLOPE_UNIT, rank * LINE_SLOPES, LINE_SLOPES, layout, &node_sub_max
+    );
+    // Each processor publishes the maximum angle from the its window
+    sub_max[rank * LINE_SLOPES] = window_max;
+
+    // Blocks until all processes in the communicator have published own n/p section maximum
+    telemetry_barrier(layout->node_comm);
+    // Maximum of all angles on the preceding nodes, which is the identity of the max-prescan on this node
+    slope_t node_offset = SLOPE_MIN;
+    // The masters of the nodes perform the inter-node exclusive max-scan of the node maximums
+    if (rank == MASTER) {
+        slope_t node_max = SLOPE_MIN;
+        for (int i = 0; i < size; i++) {
+            node_max = slope_max(node_max, sub_max[i * LINE_SLOPES]);
+        }
+        node_offset = node_exclusive_max(node_max, layout);
+    }
+    // Perform the max-prescan operation on the processor maximums - max-prescan(max)
+    max_prescan(&sub_max, node_sub_max, node_offset, LINE_SLOPES, size, rank, layout);
+
+    // Query the aligned base pointer of the node part of a shared memory window with result of the max-prescan
+    sub_max = (slope_t *) query_node_base(node_sub_max, layout->alignment);
+    slope_t offset = sub_max[rank * LINE_SLOPES];
+    // Blocks until all processes in the communicator have read own result of the max-prescan operation
+    telemetry_barrier(layout->node_comm);
+    // free shared allocated memory of the processor maximums
+    MPI_Win_free(&node_sub_max);
+    return offset;
+}
+
+void preprocess_subsets(slope_t **shared_angles, MPI_Win node_angles, const layout_t *layout) {
+    // Query the aligned base pointer of the node part of a shared memory window with shared angles
+    *shared_angles = (slope_t *) query_node_base(node_angles, layout->alignment);
+    // Each processor obtain the maximum angle from the its window
+    // max[i] = max(angels[(n/p) * i + j]) for j from 0 to n/p
+    slope_t window_max = max_slope(*shared_angles + layout->start_idx, layout->window_size, SLOPE_MIN);
+    // Obtain the maximum of all angles preceding the window of the process by the max-prescan of the maximums
+    slope_t offset = window_offset(window_max, layout);
+    // Each processor prescan self n/p section with the result of the max-prescan as the offset
+    prescan_window(*shared_angles, offset, layout);
     // Blocks until all processes in the communicator have computed own n/p section within max-prescan operation
-    MPI_Barrier(MPI_COMM_WORLD);
+    telemetry_barrier(layout->node_comm);
+}
+
+void init_scan_status(scan_status_t *status, MPI_Comm comm) {
+    // Construct the status of the process within its part of the shared memory
+    scan_status_t *own_status = new (status) scan_status_t;
+    // The process has not published any value yet
+    own_status->flag.store(STATUS_INVALID, std::memory_order_relaxed);
+    own_status->offset_flag.store(false, std::memory_order_relaxed);
+    // Blocks until all processes in the communicator have initialized own status
+    telemetry_barrier(comm);
+}
+
+slope_t lookback_offset(slope_t window_max, scan_status_t **status, MPI_Win node_status, const layout_t *layout) {
+    // Rank and size of the process within the node
+    int rank = layout->rank, size = layout->size;
+    // Query the aligned base pointer of the node part of a shared memory window with statuses of the processes
+    *status = (scan_status_t *) query_node_base(node_status, layout->alignment);
+    // Status of the calling process
+    scan_status_t *own_status = &(*status)[rank];
+
+    // Each processor publishes the maximum angle from the its window
+    own_status->aggregate = own_status->inclusive = window_max;
+    // The first process has no predecessor, thus its maximum is directly the inclusive prefix
+    own_status->flag.store((rank == MASTER) ? STATUS_PREFIX : STATUS_AGGREGATE, std::memory_order_release);
+
+    // Maximum of all angles preceding the window of the process on the node
+    slope_t exclusive = SLOPE_MIN;
+    // Look back at the predecessors until the first one with the published inclusive prefix
+    for (int i = rank - 1; i >= 0; i--) {
+        // Wait until the predecessor publishes at least the maximum of its window
+        int flag;
+        double waiting = telemetry_clock();
+        while ((flag = (*status)[i].flag.load(std::memory_order_acquire)) == STATUS_INVALID) {
+            sched_yield();
+        }
+        telemetry_waited(waiting);
+        // The inclusive prefix of the predecessor already contains all preceding maximums
+        if (flag == STATUS_PREFIX) {
+            exclusive = slope_max(exclusive, (*status)[i].inclusive);
+            break;
+        }
+        // Otherwise combine the maximum of the predecessor and continue with the next one
+        exclusive = slope_max(exclusive, (*status)[i].aggregate);
+    }
+    // Publish the inclusive prefix of the process for its successors
+    if (rank != MASTER) {
+        own_status->inclusive = slope_max(exclusive, own_status->aggregate);
+        own_status->flag.store(STATUS_PREFIX, std::memory_order_release);
+    }
+
+    // Maximum of all angles on the preceding nodes
+    slope_t node_offset = SLOPE_MIN;
+    if (layout->nodes > 1) {
+        if (rank == MASTER) {
+            // Wait until the last process of the node publishes the maximum of the whole node
+            double waiting = telemetry_clock();
+            while ((*status)[size - 1].flag.load(std::memory_order_acquire) != STATUS_PREFIX) {
+                sched_yield();
+            }
+            telemetry_waited(waiting);
+            // Perform the inter-node exclusive max-scan and publish its result for the processes of the node
+            own_status->offset = node_offset = node_exclusive_max((*status)[size - 1].inclusive, layout);
+            own_status->offset_flag.store(true, std::memory_order_release);
+        } else {
+            // Wait until the master of the node publishes the maximum of the preceding nodes
+            double waiting = telemetry_clock();
+            while (!(*status)[MASTER].offset_flag.load(std::memory_order_acquire)) {
+                sched_yield();
+            }
+            telemetry_waited(waiting);
+            node_offset = (*status)[MASTER].offset;
+        }
+    }
+    // The offset of the process is the maximum of all preceding angles
+    return slope_max(node_offset, exclusive);
+}
+
+void lookback_prescan(
+    slope_t **shared_angles, scan_status_t **status, MPI_Win node_angles, MPI_Win node_status,
+    const layout_t *layout
+) {
+    // Query the aligned base pointer of the node part of a shared memory window with shared angles
+    *shared_angles = (slope_t *) query_node_base(node_angles, layout->alignment);
+    // Each processor obtain the maximum angle from the its window
+    // max[i] = max(angels[(n/p) * i + j]) for j from 0 to n/p
+    slope_t window_max = max_slope(*shared_angles + layout->start_idx, layout->window_size, SLOPE_MIN);
+    // Obtain the maximum of all preceding angles by the look-back at the predecessors
+    slope_t offset = lookback_offset(window_max, status, node_status, layout);
+    // Each processor prescan self n/p section with the maximum of all preceding angles as the offset
+    prescan_window(*shared_angles, offset, layout);
 }
 
 void compute_results(
-    float **shared_angles, float **max_previous_angles, bool **result, MPI_Win node_angles, MPI_Win node_prev_angles,
-    MPI_Win node_results, int disp_unit, int window_size, int total_angles, int size, int rank
+    slope_t **shared_angles, slope_t **max_previous_angles, uint64_t **result, MPI_Win node_angles,
+    MPI_Win node_prev_angles, MPI_Win node_results, const layout_t *layout
 ) {
-    // Declare auxiliary window size to query at shared memory without the change relevant window size of processes
-    MPI_Aint master_window_size;
-    // Compute the start index for each process within the shared memory with respect to the common begin
-    int start_idx = (rank < total_angles % size) ? rank * window_size : rank * window_size + (total_angles % size);
-    // Query the size and base pointer for a patch of a shared memory window with shared angles
-    MPI_Win_shared_query(node_angles, MASTER, &master_window_size, &disp_unit, &(*shared_angles));
-    // Query the size and base pointer for a patch of a shared memory window with maximum previous angles (max-prescan)
-    MPI_Win_shared_query(node_prev_angles, MASTER, &master_window_size, &disp_unit, &(*max_previous_angles));
-    // Query the size and base pointer for a patch of a shared memory window to store the final results
-    MPI_Win_shared_query(node_results, MASTER, &master_window_size, &disp_unit, &(*result));
+    // Start index of the process within the shared memory with respect to the common begin of the node
+    int start_idx = layout->start_idx;
+    // Query the aligned base pointer of the node part of a shared memory window with shared angles
+    *shared_angles = (slope_t *) query_node_base(node_angles, layout->alignment);
+    // Query the aligned base pointer of the node part of a shared memory window with maximum previous angles (max-prescan)
+    *max_previous_angles = (slope_t *) query_node_base(node_prev_angles, layout->alignment);
+    // Query the aligned base pointer of the node part of a shared memory window to store the final results
+    *result = (uint64_t *) query_node_base(node_results, layout->alignment);
     // in parallel for each process window
-    for (size_t i = start_idx; i < start_idx + window_size; i++) {
-        // if (angles[i] > max-previous-angles[i]) result[i] = visible else not visible
-        (*result)[i] = ((*shared_angles)[i] > (*max_previous_angles)[i]);
+    // if (angles[i] > max-previous-angles[i]) result[i] = visible else not visible
+    compare_slopes(
+            *shared_angles + start_idx, *max_previous_angles + start_idx, layout->window_size,
+            *result + start_idx / WORD_BITS
+    );
+    // Blocks until all processes in the communicator have computed own n/p section of final results
+    telemetry_barrier(layout->node_comm);
+}
+
+slope_t suffix_offset(slope_t window_max, const layout_t *layout) {
+    // Returns the number of all processes and the position of the process within their sequence
+    int processes, position = layout->node_position + layout->rank, mirror_rank;
+    MPI_Comm_size(layout->comm, &processes);
+    // Create the communicator of all processes in the reverse order of their positions
+    MPI_Comm mirror_comm;
+    MPI_Comm_split(layout->comm, 0, processes - 1 - position, &mirror_comm);
+    MPI_Comm_rank(mirror_comm, &mirror_rank);
+    // Create the operation computing the maximum of the slopes (commutative)
+    MPI_Op slope_max_op;
+    MPI_Op_create(&slope_max_operation, true, &slope_max_op);
+    // The exclusive max-scan in the reverse order is the maximum of all following windows
+    slope_t offset = SLOPE_MIN;
+    double waiting = telemetry_clock();
+    MPI_Exscan(&window_max, &offset, COUNT, MPI_2INT, slope_max_op, mirror_comm);
+    telemetry_waited(waiting);
+    // The result of the exclusive scan is undefined on the last process
+    if (mirror_rank == MASTER) {
+        offset = SLOPE_MIN;
     }
+    MPI_Op_free(&slope_max_op);
+    MPI_Comm_free(&mirror_comm);
+    return offset;
+}
+
+template <typename altitude_t>
+void fused_results(
+    const altitude_t *altitudes, uint64_t **result, scan_status_t **status, MPI_Win node_results, MPI_Win node_status,
+    int observer_altitude, int scan, const layout_t *layout
+) {
+    // Start index of the process within the shared memory with respect to the common begin of the node
+    int start_idx = layout->start_idx;
+    // Indices of the first altitude of the process window and of the altitude after it, and of the observer
+    long long first = layout->node_first + start_idx, last = first + layout->window_size, observer = layout->observer;
+    // The part of the window after the observer is swept forward, the part before the observer backward
+    long long right = std::max(first, observer + 1), left_end = std::min(last, observer);
+    size_t right_count = std::max(0LL, last - right), left_count = std::max(0LL, left_end - first);
+    // Altitudes of the process window
+    const altitude_t *window = altitudes + start_idx;
+    // Query the aligned base pointer of the node part of a shared memory window to store the final results
+    *result = (uint64_t *) query_node_base(node_results, layout->alignment);
+    uint64_t *window_result = *result + start_idx / WORD_BITS;
+
+    // The first pass: each processor obtain the maximum angles from the altitudes on both sides of the observer
+    slope_t right_max = max_altitude_slope(
+            window + (right - first), observer_altitude, right - observer, right_count, SLOPE_MIN
+    );
+    slope_t left_max = max_altitude_slope_backward(
+            window, observer_altitude, observer - left_end + 1, left_count, SLOPE_MIN
+    );
+    // Obtain the maximum of all angles preceding the window of the process by the selected engine
+    slope_t right_offset = (scan == SCAN_LOOKBACK) ?
+                           lookback_offset(right_max, status, node_status, layout) :
+                           window_offset(right_max, layout);
+    // Obtain the maximum of all angles following the window, there is nothing before the observer at the begin
+    slope_t left_offset = observer ? suffix_offset(left_max, layout) : SLOPE_MIN;
+
+    // The second pass: compute the angles, their running maximums and the results of the window at once
+    memset(window_result, 0, RESULT_WORDS(layout->window_size) * WORD_UNIT);
+    sweep_slopes(
+            window + (right - first), observer_altitude, right - observer, right_count, right_offset, window_result,
+            right - first
+    );
+    sweep_slopes_backward(
+            window, observer_altitude, observer - left_end + 1, left_count, left_offset, window_result, 0
+    );
     // Blocks until all processes in the communicator have computed own n/p section of final results
-    MPI_Barrier(MPI_COMM_WORLD);
+    telemetry_barrier(layout->node_comm);
+}
+
+int observer_altitude_of(const int *node_part, const layout_t *layout) {
+    // Index of the first altitude of the process window
+    long long first = layout->node_first + layout->start_idx;
+    // Only the process, which window contains the observer, contributes its altitude
+    int altitude = INT_MIN;
+    if (layout->observer >= first && layout->observer < first + layout->window_size) {
+        altitude = node_part[layout->observer - layout->node_first];
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &altitude, COUNT, MPI_INT, MPI_MAX, layout->comm);
+    return altitude;
+}
+
+void allocate_windows(windows_t *windows, const settings_t *settings, const layout_t *layout) {
+    // Allocate shared window to store the statuses of the processes within the single-pass max-prescan
+    if (settings->scan == SCAN_LOOKBACK) {
+        windows->status = (scan_status_t *) allocate_node_window(
+                layout->size, STATUS_UNIT, layout->rank, COUNT, layout, &windows->node_status
+        );
+    }
+    // Allocate shared window to store the final results of the line-of-sight problem
+    windows->result = (uint64_t *) allocate_node_window(
+            RESULT_WORDS(layout->node_count), WORD_UNIT, layout->start_idx / WORD_BITS,
+            RESULT_WORDS(layout->window_size), layout, &windows->node_results
+    );
+    // The fused pipeline needs no shared windows of the angles
+    if (!settings->fused) {
+        // Allocate shared window to store the computed angles.
+        windows->shared_angles = (slope_t *) allocate_node_window(
+                layout->node_count, SLOPE_UNIT, layout->start_idx, layout->window_size, layout, &windows->node_angles
+        );
+        // Allocate shared window to store the maximum previous angles in the next phase of the algorithm, the
+        // max-prescan over all angles addresses also the nodes of its tree beyond the last angle
+        windows->max_previous_angles = (slope_t *) allocate_node_window(
+                layout->node_count + PRESCAN_TAIL(layout->size), SLOPE_UNIT, layout->start_idx, layout->window_size,
+                layout, &windows->node_prev_angles
+        );
+    }
+}
+
+void free_windows(windows_t *windows, const settings_t *settings) {
+    // free shared allocated memories of each process
+    if (!settings->fused) {
+        MPI_Win_free(&windows->node_angles);
+        MPI_Win_free(&windows->node_prev_angles);
+    }
+    MPI_Win_free(&windows->node_results);
+    if (settings->scan == SCAN_LOOKBACK) {
+        MPI_Win_free(&windows->node_status);
+    }
+}
+
+template <typename altitude_t>
+void sequential_results(const altitude_t *altitudes, uint64_t *result, int observer_altitude, const layout_t *layout) {
+    // The sweeps combine the bits of the visible altitudes to the zero words
+    std::fill(result, result + RESULT_WORDS(layout->total_altitudes), 0);
+    // Sweep the altitudes after the observer forward and the altitudes before it backward
+    sweep_slopes(
+            altitudes + layout->observer + 1, observer_altitude, 1, layout->total_altitudes - layout->observer - 1,
+            SLOPE_MIN, result, layout->observer + 1
+    );
+    sweep_slopes_backward(altitudes, observer_altitude, 1, layout->observer, SLOPE_MIN, result, 0);
+}
+
+void prescan_angles(windows_t *windows, const settings_t *settings, const layout_t *layout) {
+    // Check whether the single-pass max-prescan was selected, it needs no pre-processing
+    if (settings->scan == SCAN_LOOKBACK) {
+        lookback_prescan(
+                &windows->max_previous_angles, &windows->status, windows->node_prev_angles, windows->node_status,
+                layout
+        );
+    // Check whether is the required number of processes to perform only the max-prescan operation itself
+    } else if (layout->nodes > 1 || layout->size < ceil(layout->total_altitudes / 2.0)) {
+        // When the number of processes is not satisfied, then first pre-processing the vector of angles
+        preprocess_subsets(&windows->max_previous_angles, windows->node_prev_angles, layout);
+    } else {
+        // When the number of processes is satisfied, then perform an only max-prescan operation itself
+        max_prescan(
+                &windows->max_previous_angles, windows->node_prev_angles, SLOPE_MIN, COUNT,
+                layout->total_altitudes, layout->rank, layout
+        );
+    }
+}
+
+template <typename altitude_t>
+void solve_line_of_sight(
+    const altitude_t *node_part, windows_t *windows, int observer_altitude, const settings_t *settings,
+    const layout_t *layout
+) {
+    // The only participating process computes the results sequentially, unless the angles are summarized
+    if (layout->nodes == 1 && layout->size == 1 && settings->summary != SUMMARY_HORIZON) {
+        telemetry_begin(TELEMETRY_RESULTS, layout->total_altitudes);
+        sequential_results(node_part, windows->result, observer_altitude, layout);
+        telemetry_end();
+        return;
+    }
+    // The fused pipeline records the whole computation as the phase of the results
+    telemetry_begin(settings->fused ? TELEMETRY_RESULTS : TELEMETRY_ANGLES, layout->window_size);
+    // Each process initializes its status of the single-pass max-prescan
+    if (settings->scan == SCAN_LOOKBACK) {
+        init_scan_status(windows->status + layout->rank, layout->node_comm);
+    }
+    // The fused pipeline computes the results in two passes over the altitudes of each process
+    if (settings->fused) {
+        fused_results(
+                node_part, &windows->result, &windows->status, windows->node_results, windows->node_status,
+                observer_altitude, settings->scan, layout
+        );
+        telemetry_end();
+        return;
+    }
+    // Compute the angles by all processes and store the results in the given allocated shared memories
+    compute_angles(
+            node_part, &windows->shared_angles, &windows->max_previous_angles, windows->node_angles,
+            windows->node_prev_angles, observer_altitude, layout
+    );
+    telemetry_end();
+
+    // Compute the maximum previous angles by the selected engine of the max-prescan
+    telemetry_begin(TELEMETRY_PRESCAN, layout->window_size);
+    prescan_angles(windows, settings, layout);
+    telemetry_end();
+
+    // Compute the final results of the line-of-sight problem - subtraction of angle and maximum previous angle
+    telemetry_begin(TELEMETRY_RESULTS, layout->window_size);
+    compute_results(
+            &windows->shared_angles, &windows->max_previous_angles, &windows->result, windows->node_angles,
+            windows->node_prev_angles, windows->node_results, layout
+    );
+    telemetry_end();
+}
+
+// Instantiates the pipeline for the given type of the stored altitudes
+#define INSTANTIATE_PIPELINE(altitude_t) \
+    template void compute_angles( \
+        const altitude_t *, slope_t **, slope_t **, MPI_Win, MPI_Win, int, const layout_t *); \
+    template void solve_line_of_sight( \
+        const altitude_t *, windows_t *, int, const settings_t *, const layout_t *);
+
+INSTANTIATE_PIPELINE(int16_t)
+INSTANTIATE_PIPELINE(int)
+
+void solve_node_part(
+    const void *node_part, uint32_t element_type, windows_t *windows, int observer_altitude,
+    const settings_t *settings, const layout_t *layout
+) {
+    // Select the specialization of the pipeline reading the altitudes directly in their stored type
+    switch (element_type) {
+        case altitude_traits<int16_t>::element_type:
+            solve_line_of_sight((const int16_t *) node_part, windows, observer_altitude, settings, layout);
+            break;
+        default:
+            solve_line_of_sight((const int *) node_part, windows, observer_altitude, settings, layout);
+    }
 }
 
-void write_out_result(
-    bool **result, MPI_Win node_results, MPI_Aint window_size, int disp_unit, int total_altitudes
+void gather_results(
+    uint64_t **result, MPI_Win node_results, std::vector<uint64_t> *gathered, const layout_t *layout
 ) {
-    // Query the size and base pointer for a patch of a shared memory window with stored final results
-    MPI_Win_shared_query(node_results, MASTER, &window_size, &disp_unit, &(*result));
-    // Write out the place of the observation
-    std::cout << "_,";
-    // Write out the result for each origina altitude
-    for (size_t i = 1; i < total_altitudes - 1; i++) {
-        // Write out the result in the specified format - visible (v) or unvisible (u)
-        std::cout << ((*result)[i] ? "v," : "u,");
+    // Only the masters of the nodes take part in the gathering of the results
+    if (layout->rank != MASTER) {
+        return;
+    }
+    // Query the aligned base pointer of the node part of a shared memory window with stored final results
+    *result = (uint64_t *) query_node_base(node_results, layout->alignment);
+    // The shared window of the only one node already contains all results
+    if (layout->nodes == 1) {
+        return;
+    }
+    // Master process obtains the parts of all nodes and prepares the vector for all results
+    std::vector<int> counts, displacements;
+    gather_node_parts(&counts, &displacements, layout);
+    if (layout->world_rank == MASTER) {
+        gathered->resize(RESULT_WORDS(layout->total_altitudes));
+        // The parts of the nodes start at the begin of the words, thus they are gathered as the whole words
+        for (int i = 0; i < layout->nodes; i++) {
+            counts[i] = RESULT_WORDS(counts[i]);
+            displacements[i] /= WORD_BITS;
+        }
+    }
+    // Gather the node parts of the results to the vector of the master process
+    double waiting = telemetry_clock();
+    MPI_Gatherv(
+            *result, RESULT_WORDS(layout->node_count), MPI_UINT64_T, gathered->data(), counts.data(),
+            displacements.data(), MPI_UINT64_T, MASTER, layout->leaders_comm
+    );
+    telemetry_waited(waiting);
+    // The results of the master process are the gathered results of all nodes
+    *result = gathered->data();
+}
+
+bool write_out_result(const uint64_t *result, int total_altitudes, int observer, int output) {
+    // Write out the results in the selected format to the standard output at once
+    switch (output) {
+        case OUTPUT_RAW:
+            return write_raw(stdout, result, total_altitudes);
+        case OUTPUT_RLE:
+            return write_rle(stdout, result, total_altitudes, observer);
+        default:
+            return write_text(stdout, result, total_altitudes, observer);
     }
-    // Write out the result for the last altitude (without the comma after it)
-    std::cout << ((*result)[total_altitudes - 1] ? "v" : "u") << std::endl;
 }
 
 int main(int argc, char **argv) {
     // Create the variables to store information data within all processors
-    int rank, size, total_altitudes, disp_unit;
+    int observer_altitude, processes;
+    // Settings of the program given on the command line
+    settings_t settings;
+    // Layout of the processes to the nodes and of the altitudes to the processes
+    layout_t layout;
     // Create an area of memory for each processors to shared allocated memory (windows within shared array)
-    MPI_Win node_altitudes, node_angles, node_prev_angles, node_results;
-    // Multiple of the displacement unit that was specified in the window definition for each process
-    MPI_Aint window_size;
-    // Define the vector to store the loaded altitudes from the input line of sight
+    MPI_Win node_altitudes;
+    // Shared windows of the angles, of the statuses and of the final results
+    windows_t windows;
+    // Define the vector to store the loaded altitudes from the input line of sight (only to write the profile)
     std::vector<int> altitudes;
+    // Define the line of sight given on the command line or mapped from the file
+    text_t text;
+    // Define the vector to store the gathered results of all nodes on the master process
+    std::vector<uint64_t> gathered;
     // Define the shared pointer to allocate shared window to store loaded altitudes between all processes
     int *shared_altitudes;
-    // Define the shared pointers to allocate shared window to store computed angles between all processes
-    float *shared_angles, *max_previous_angles;
-    // Define the shared pointer to allocate shared window to store final results of the line-of-sight problem
-    bool *result;
+    // Define the binary profile mapped by all processes instead of the shared window of the altitudes
+    profile_t profile;
+    // Define the pointer to the altitudes of the node part (shared window or mapped profile) and their type
+    const void *node_part;
+    uint32_t element_type = PROFILE_INT32;
 
 // Potential definition of the variable to measure the runtime of the algorithm for line-of-sight problem
 #ifdef MEASURE_TIME
@@ -250,69 +1206,225 @@ int main(int argc, char **argv) {
 
     // Initializes the MPI execution environment
     MPI_Init(&argc, &argv);
-    // Returns the size of the group associated with a communicator
-    MPI_Comm_size(MPI_COMM_WORLD, &size);
-    // Determines the rank of the calling process in the communicator
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    // Parse the arguments given on the command line, the master process reports the invalid ones
+    if (!parse_arguments(argc, argv, &settings)) {
+        MPI_Comm_rank(MPI_COMM_WORLD, &layout.world_rank);
+        if (layout.world_rank == MASTER) {
+            std::cerr << USAGE;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    // The clocks of the telemetry start at once within all processes
+    if (settings.telemetry || settings.trace) {
+        telemetry_start(MPI_COMM_WORLD);
+    }
+    // The parts of the processes are aligned to the pages, when their owners place them, otherwise to the cache lines
+    layout.placement = settings.placement;
+    layout.alignment = (settings.placement == PLACEMENT_HUGE) ? HUGE_PAGE_ALIGN :
+                       (settings.placement == PLACEMENT_LOCAL) ? PAGE_ALIGN : CACHE_LINE;
+    // Split the processes to the nodes with the shared memory and create the communicator of their masters
+    layout.comm = MPI_COMM_WORLD;
+    split_to_nodes(&layout);
+    MPI_Comm_size(MPI_COMM_WORLD, &processes);
+    // The observer is placed at the first altitude, unless the profile or the command line places it elsewhere
+    layout.observer = 0;
 
-    // Master process loads the line-of-sight given on the input (first argument on the command line - argv[1])
-    if (rank == MASTER) {
-        // Load and parse the input line-of-sight to the vector of altitudes
-        load_line_of_sight(argv[1], &altitudes);
-        // Save the number of the loaded altitudes for subsequent sharing between all processes in this variable
-        total_altitudes = altitudes.size();
-    }
-    // Broadcast a number of altitudes from the master process to all other process of the communicator MPI_COMM_WORLD
-    MPI_Bcast(&total_altitudes, COUNT, MPI_INT, MASTER, MPI_COMM_WORLD);
-    // Assign the relevant number of altitudes for each process and allocate the relevant shared memory
-    share_points_to_process(&shared_altitudes, &node_altitudes, &window_size, total_altitudes, size, altitudes, rank);
-
-    // Create an window for one-sided communication and shared memory access, and allocate memory at each process
-    // Allocate shared window to store the computed angles.
-    MPI_Win_allocate_shared(
-            window_size * FLOAT_UNIT, FLOAT_UNIT, MPI_INFO_NULL, MPI_COMM_WORLD, &shared_angles, &node_angles
-    );
-    // Create an window for one-sided communication and shared memory access, and allocate memory at each process
-    // Allocate shared window to store the maximum previous angles in the next phase of the algorithm
-    MPI_Win_allocate_shared(
-            window_size * FLOAT_UNIT, FLOAT_UNIT, MPI_INFO_NULL, MPI_COMM_WORLD, &max_previous_angles, &node_prev_angles
-    );
+    // The calibration only writes out the measured cost model in the format accepted by the option -m
+    if (settings.calibrate || settings.benchmark) {
+        if (settings.benchmark) {
+            run_benchmark(&settings, &layout);
+        } else {
+            calibrate_cost_model(&settings.model, &layout);
+            if (layout.world_rank == MASTER) {
+                printf("%.3f,%.3f\n", settings.model.point, settings.model.sync);
+            }
+        }
+        if (layout.leaders_comm != MPI_COMM_NULL) {
+            MPI_Comm_free(&layout.leaders_comm);
+        }
+        MPI_Comm_free(&layout.node_comm);
+        MPI_Finalize();
+        return 0;
+    }
+
+    // The server keeps the processes and the shared windows alive across the stream of the lines of sight
+    if (settings.server) {
+        int code = 1;
+        if (!settings.incremental) {
+            code = serve_requests(&settings, &layout);
+        } else if (processes > 1) {
+            // The incremental server executes the commands by the one process, the other ones would only wait
+            report_error("the incremental server runs on the one process only", layout.world_rank);
+        } else {
+            code = serve_incremental(&settings, &layout);
+        }
+        if (layout.leaders_comm != MPI_COMM_NULL) {
+            MPI_Comm_free(&layout.leaders_comm);
+        }
+        MPI_Comm_free(&layout.node_comm);
+        MPI_Finalize();
+        return code;
+    }
+
+    // The viewshed casts the rays over the whole grid instead of the one line of sight, the tiled
+    // processing streams the profile larger than the memory
+    if (settings.grid_width || settings.tile) {
+        int code = settings.tile ? process_tiles(&settings, &layout) : compute_viewshed(&settings, &layout);
+        if (layout.leaders_comm != MPI_COMM_NULL) {
+            MPI_Comm_free(&layout.leaders_comm);
+        }
+        MPI_Comm_free(&layout.node_comm);
+        MPI_Finalize();
+        return code;
+    }
+
+    // Each process maps the binary profile and it reads its part of the altitudes directly from it
+    if (settings.input) {
+        if (!map_profile(settings.input, &profile, &observer_altitude, &layout)) {
+            MPI_Finalize();
+            return 1;
+        }
+        // The observer given on the command line overrides the observer of the profile
+        if (settings.observer >= 0 && settings.observer < layout.total_altitudes) {
+            layout.observer = settings.observer;
+            observer_altitude = profile_altitude(&profile, layout.observer);
+        }
+        // The surplus processes are parked, they only unmap the profile
+        if (!park_processes(schedule_processes(layout.total_altitudes, processes, &settings.model), &layout)) {
+            close_profile(&profile);
+            MPI_Finalize();
+            return 0;
+        }
+        // Assign the relevant number of altitudes for each process
+        assign_points_to_process(&layout);
+        // The node part of the altitudes starts at the first altitude of the node within the mapped profile
+        element_type = profile.header->element_type;
+        node_part = (const char *) profile.altitudes + layout.node_first * profile_element_size(element_type);
+    } else {
+        // Each process obtains the line of sight given on the command line or mapped from the file
+        if (!open_line_of_sight(&settings, &text, layout.world_rank)) {
+            MPI_Finalize();
+            return 1;
+        }
+        // Master process only converts the line of sight to the binary profile
+        if (settings.write_profile) {
+            int written = 0;
+            if (layout.world_rank == MASTER) {
+                // Load and parse the input line-of-sight to the vector of altitudes
+                load_line_of_sight(&text, &altitudes);
+                // The observer is placed at the first altitude, when it is not given on the command line
+                uint64_t observer = std::max(settings.observer, 0LL);
+                written = observer < altitudes.size() &&
+                          write_profile(
+                                  settings.write_profile, altitudes.data(), altitudes.size(), observer,
+                                  settings.element_type
+                          );
+            }
+            MPI_Bcast(&written, COUNT, MPI_INT, MASTER, MPI_COMM_WORLD);
+            if (!written) {
+                report_error("cannot write the profile", layout.world_rank);
+            }
+            close_text(&text);
+            MPI_Finalize();
+            return written ? 0 : 1;
+        }
+        // All processes count the altitudes of the line of sight in parallel
+        std::vector<long long> firsts;
+        if (!count_points_to_process(&text, &firsts, &observer_altitude, &layout)) {
+            report_error("unsupported number of the altitudes in the line of sight", layout.world_rank);
+            close_text(&text);
+            MPI_Finalize();
+            return 1;
+        }
+        // The surplus processes are parked, the participating ones obtain their parts of the altitudes again
+        if (!park_processes(schedule_processes(layout.total_altitudes, processes, &settings.model), &layout)) {
+            close_text(&text);
+            MPI_Finalize();
+            return 0;
+        }
+        assign_points_to_process(&layout);
+        // Each process parses its own part of the line of sight to the shared memory of the node
+        telemetry_begin(TELEMETRY_LOAD, layout.window_size);
+        share_points_to_process(&shared_altitudes, &node_altitudes, &text, &firsts, &layout);
+        telemetry_end();
+        // The parsed altitudes are stored within the shared memory, the text is not needed anymore
+        close_text(&text);
+        node_part = shared_altitudes;
+        // The observer is placed at the first altitude, when it is not given on the command line
+        if (settings.observer > 0 && settings.observer < layout.total_altitudes) {
+            layout.observer = settings.observer;
+            observer_altitude = observer_altitude_of(shared_altitudes, &layout);
+        }
+    }
+
+    // The observer given on the command line has to be placed at one of the altitudes
+    if (settings.observer >= layout.total_altitudes) {
+        report_error("the observer is out of the line of sight", layout.world_rank);
+        if (settings.input) {
+            close_profile(&profile);
+        } else {
+            MPI_Win_free(&node_altitudes);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    // The batch of the observers reuses the loaded altitudes for all observers of the list
+    if (settings.observers) {
+        int code = solve_observers(node_part, element_type, &settings, &layout);
+        if (settings.input) {
+            close_profile(&profile);
+        } else {
+            MPI_Win_free(&node_altitudes);
+        }
+        if (layout.leaders_comm != MPI_COMM_NULL) {
+            MPI_Comm_free(&layout.leaders_comm);
+        }
+        MPI_Comm_free(&layout.node_comm);
+        if (layout.comm != MPI_COMM_WORLD) {
+            MPI_Comm_free(&layout.comm);
+        }
+        MPI_Finalize();
+        return code;
+    }
+    // The observer placed within the line of sight is processed only by the fused pipeline
+    settings.fused |= (layout.observer != 0);
+    // The horizon of the observer placed within the profile would need the angles of the fused pipeline
+    if (settings.summary == SUMMARY_HORIZON && settings.fused) {
+        report_error("the horizon needs the observer at the first altitude", layout.world_rank);
+        if (settings.input) {
+            close_profile(&profile);
+        } else {
+            MPI_Win_free(&node_altitudes);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    // Allocate the shared windows of the angles, of the statuses and of the final results
+    allocate_windows(&windows, &settings, &layout);
 
 // The starting point of measuring the runtime of the line-of-sight algorithm
-    if (rank == MASTER) {
+    if (layout.world_rank == MASTER) {
 #ifdef MEASURE_TIME
         start = MPI_Wtime();
 #endif
     }
 
-    // Compute the angles by all processes and store the results in the given allocated shared memories
-    compute_angles(
-            &shared_altitudes, &shared_angles, &max_previous_angles, node_altitudes, node_angles,
-            node_prev_angles, window_size, disp_unit, total_altitudes, size, rank
-    );
-
-    // Check whether is the required number of processes to perform only the max-prescan operation itself
-    if (size < ceil(total_altitudes / 2.0)) {
-        // When the number of processes is not satisfied, then first pre-processing the vector of angles
-        preprocess_subsets(&max_previous_angles, node_prev_angles, window_size, disp_unit, total_altitudes, size, rank);
+    // Compute the final results of the line-of-sight problem by all processes
+    solve_node_part(node_part, element_type, &windows, observer_altitude, &settings, &layout);
+    // Collect the results of all nodes on the master process, or only the merged summary of the results
+    summary_t summary;
+    if (settings.summary != SUMMARY_NONE) {
+        telemetry_begin(TELEMETRY_GATHER, layout.window_size);
+        summarize_results(&windows, &settings, &summary, &layout);
     } else {
-        // When the number of processes is satisfied, then perform an only max-prescan operation itself
-        max_prescan(&max_previous_angles, node_prev_angles, window_size, disp_unit, total_altitudes, size, rank);
+        telemetry_begin(TELEMETRY_GATHER, (layout.rank == MASTER) ? layout.node_count : 0);
+        gather_results(&windows.result, windows.node_results, &gathered, &layout);
     }
-
-    // Create an window for one-sided communication and shared memory access, and allocate memory at each process
-    // Allocate shared window to store the final results of the line-of-sight problem
-    MPI_Win_allocate_shared(
-            window_size * BOOL_UNIT, BOOL_UNIT, MPI_INFO_NULL, MPI_COMM_WORLD, &result, &node_results
-    );
-    // Compute the final results of the line-of-sight problem - subtraction of angle and maximum previous angle
-    compute_results(
-            &shared_angles, &max_previous_angles, &result, node_angles, node_prev_angles,
-            node_results, disp_unit, window_size, total_altitudes, size, rank
-    );
+    telemetry_end();
 
 // The ending point of measuring the runtime of the line-of-sight algorithm
-    if (rank == MASTER) {
+    if (layout.world_rank == MASTER) {
 #ifdef MEASURE_TIME
         double end = MPI_Wtime();
         // Write out the runtime of the algorithm to the standard output in the microseconds
@@ -320,16 +1432,37 @@ int main(int argc, char **argv) {
 #endif
     }
 
+    // Master process writes out the telemetry of all participating processes
+    if ((settings.telemetry || settings.trace) &&
+        !telemetry_report(layout.comm, layout.node, settings.telemetry, settings.trace)) {
+        report_error("cannot write the telemetry trace", layout.world_rank);
+    }
+
     // Master process write the out the final results of the line-of sight problem
-    if (rank == MASTER) {
-        write_out_result(&result, node_results, window_size, disp_unit, total_altitudes);
+    if (layout.world_rank == MASTER) {
+        bool written = (settings.summary != SUMMARY_NONE) ?
+                       write_summary(stdout, &summary, &settings) :
+                       write_out_result(windows.result, layout.total_altitudes, layout.observer, settings.output);
+        if (!written) {
+            report_error("cannot write out the results", layout.world_rank);
+        }
     }
 
-    // free shared allocated memories of each process
-    MPI_Win_free(&node_altitudes);
-    MPI_Win_free(&node_angles);
-    MPI_Win_free(&node_prev_angles);
-    MPI_Win_free(&node_results);
+    // free shared allocated memories of each process or unmap the binary profile
+    if (settings.input) {
+        close_profile(&profile);
+    } else {
+        MPI_Win_free(&node_altitudes);
+    }
+    free_windows(&windows, &settings);
+    // free the communicators of the nodes and of their masters
+    if (layout.leaders_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&layout.leaders_comm);
+    }
+    MPI_Comm_free(&layout.node_comm);
+    if (layout.comm != MPI_COMM_WORLD) {
+        MPI_Comm_free(&layout.comm);
+    }
 
     // Terminates MPI execution environment
     MPI_Finalize();
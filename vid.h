@@ -5,7 +5,7 @@
  * Faculty: 	Faculty of Information Technology
  * Course:	    Parallel and Distributed Algorithms
  * Date:		03.04.2020
- * Last change:	07.04.2020
+ * Last change:	17.10.2026
  *
  * Subscribe:	The header module of the program implementing Line-of-Sight problem.
  *
@@ -17,11 +17,29 @@
  *          and macros and also declarations of the functions.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <climits>
 #include <cmath>
+#include <cstring>
+#include <getopt.h>
+#include <iostream>
 #include <limits>
 #include <mpi.h>
+#include <new>
+#include <sched.h>
+#include <string>
 #include <vector>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "kernel.h"
+#include "incremental.h"
+#include "output.h"
+#include "profile.h"
+#include "telemetry.h"
 
 // The rank of the master processor
 #define MASTER 0
@@ -31,138 +49,1105 @@
 //#define MEASURE_TIME
 // Size of the integer variable to use as the size of the elements within the shared memory
 #define INT_UNIT sizeof(int)
-// Size of the float (double) variable to use as the size of the elements within the shared memory
-#define FLOAT_UNIT sizeof(float)
-// Size of the boolean variable to use as the size of the elements within the shared memory
-#define BOOL_UNIT sizeof(bool)
+// Size of the word of the bitset to use as the size of the elements within the shared memory
+#define WORD_UNIT sizeof(uint64_t)
+// Number of the words of the bitset storing the results of the given number of the altitudes
+#define RESULT_WORDS(x) (((x) + WORD_BITS - 1) / WORD_BITS)
+// Size of the cache line in bytes, the statuses of the single-pass max-prescan are aligned to it
+#define CACHE_LINE 64
+// Size of the status of the process within the single-pass max-prescan (one cache line)
+#define STATUS_UNIT sizeof(scan_status_t)
+// The process has not published anything yet within the single-pass max-prescan
+#define STATUS_INVALID 0
+// The process has published the maximum of its own window (aggregate)
+#define STATUS_AGGREGATE 1
+// The process has published the maximum of all windows up to its own one (inclusive prefix)
+#define STATUS_PREFIX 2
+// Usage of the program written out when the arguments are not valid
+#define USAGE "Usage: vid [-s tree|lookback] [-f] [-o text|raw|rle] [-x OBSERVER] [-m POINT,SYNC]\n" \
+              "           [-r] [-R TRACE] [-P local|huge] [-q intervals|count|furthest|horizon[:STEP]]\n" \
+              "           LINE_OF_SIGHT | -t FILE | -i PROFILE\n" \
+              "       vid [-s tree|lookback] [-f] [-o text|rle] -S | -u SOCKET\n" \
+              "       vid [-o text|raw] -X OBSERVERS LINE_OF_SIGHT | -t FILE | -i PROFILE\n" \
+              "       vid [-o text|rle] -I [-u SOCKET]  (one process only)\n" \
+              "       vid [-o text|raw] [-x OBSERVER] -g WIDTH -i PROFILE\n" \
+              "       vid [-o text|raw] -T TILE -i PROFILE\n" \
+              "       vid -C\n" \
+              "       vid [-s tree|lookback] [-P local|huge] -b REPETITIONS\n" \
+              "       vid [-x OBSERVER] [-e int32|int16] -w PROFILE LINE_OF_SIGHT | -t FILE\n"
+// Max-prescan of the processor maximums by the Blelloch tree with the barrier per level
+#define SCAN_TREE 0
+// Single-pass max-prescan of the processor maximums by the decoupled look-back
+#define SCAN_LOOKBACK 1
+// Default cost of the processing of one altitude by one process in nanoseconds (see cost_model_t)
+#define COST_POINT 1.0
+// Default cost of one level of the synchronisation of the processes in nanoseconds (see cost_model_t)
+#define COST_SYNC 2000.0
+// Number of the synchronisations of the pipeline besides the levels of the max-prescan tree
+#define COST_STAGES 4
+// Number of the altitudes swept by the calibration of the cost of one altitude
+#define CALIBRATION_POINTS (1 << 22)
+// Number of the barriers measured by the calibration of the cost of the synchronisation
+#define CALIBRATION_BARRIERS 100
+// Synthetic terrains of the benchmark - uniformly random, constantly rising and convex altitudes
+#define TERRAIN_RANDOM 0
+#define TERRAIN_MONOTONE 1
+#define TERRAIN_WORST 2
+#define TERRAINS 3
+// Measured phases of the pipeline within the benchmark
+#define PHASE_LOAD 0
+#define PHASE_SHARE 1
+#define PHASE_ANGLES 2
+#define PHASE_PRESCAN 3
+#define PHASE_RESULTS 4
+#define PHASE_GATHER 5
+#define PHASE_OUTPUT 6
+#define PHASES 7
+// Range of the numbers of the altitudes of the benchmark, each size is BENCH_SIZE_STEP times the previous one
+#define BENCH_MIN_SIZE (1 << 10)
+#define BENCH_MAX_SIZE (1 << 22)
+#define BENCH_SIZE_STEP 4
+// Number of the rays of the viewshed assigned to the process at once by the shared counter
+#define VIEWSHED_CHUNK 64
+// Number of the observers of the batch solved together over the same tiles of the altitudes
+#define BATCH_BLOCK 16
+// Number of the altitudes of one tile of the process window, over which all observers of the block are swept
+#define BATCH_TILE (1 << 14)
+// Summaries written out instead of the results of all points - the visible intervals, the number of the visible
+// points, the furthest visible point and the horizon sampled by the given step
+#define SUMMARY_NONE 0
+#define SUMMARY_INTERVALS 1
+#define SUMMARY_COUNT 2
+#define SUMMARY_FURTHEST 3
+#define SUMMARY_HORIZON 4
+// Default number of the points between two samples of the horizon
+#define HORIZON_STEP 1024
+// Initial size of the buffer of the requests read by the server (it grows for the longer lines)
+#define SERVER_BUFFER (1 << 20)
+// Requests shorter than this number of bytes are processed whole by the one process within the server
+#define SERVER_SHORT (1 << 18)
+// Placement of the shared windows - the pages are placed by the MPI library, they are touched first by their
+// owners (aligned to the pages), or they are also backed by the transparent huge pages (aligned to the huge pages)
+#define PLACEMENT_DEFAULT 0
+#define PLACEMENT_LOCAL 1
+#define PLACEMENT_HUGE 2
+// Alignment of the node parts of the shared windows and of the parts of the processes in bytes by the placement
+// (the default placement aligns them to CACHE_LINE)
+#define PAGE_ALIGN 4096
+#define HUGE_PAGE_ALIGN (2 << 20)
+// Number of the slopes within one cache line, the maximums of the processes are published one per line
+#define LINE_SLOPES (CACHE_LINE / SLOPE_UNIT)
+// Size of the region of each process and number of its reads within the measurement of the placement
+#define PLACEMENT_BYTES (1 << 24)
+#define PLACEMENT_READS 8
+// Number of the altitudes, by which the parts of the processes are aligned (whole words and whole aligned slopes)
+#define ALIGN_POINTS(alignment) std::max((size_t) WORD_BITS, (size_t) (alignment) / SLOPE_UNIT)
 // Macro that finds the nearest power of two according to the given number x
-#define NEXT_POWER_2(x) ((x == 1) ? 1 : ((1ULL << sizeof(x) * CHAR_BIT) >> __builtin_clz(x - 1)))
-// Define the minimum of the float numbers to use as the neutral element (I) within max-prescan operation
-#define FLOAT_MIN -std::numeric_limits<float>::max()
+#define NEXT_POWER_2(x) ((x == 1) ? 1 : (1ULL << (64 - __builtin_clzll((unsigned long long) (x) - 1))))
+// Number of the elements addressed by the max-prescan tree of the given number of the processes (the pairs of the
+// processes and the root), which may exceed the number of the processed elements
+#define PRESCAN_TAIL(size) (2 * (size) + NEXT_POWER_2(2 * (size)))
 
 using namespace std;
 
+/**
+ * The cost model of the machine used to choose the number of the participating processes.
+ * The runtime of p processes is estimated as n/p * point + (2 * ceil(log p) + COST_STAGES) * sync,
+ * the single process runs the sequential sweep without any synchronisation.
+ */
+typedef struct cost_model {
+    // Cost of the processing of one altitude by one process in nanoseconds
+    double point;
+    // Cost of one level of the synchronisation of the processes in nanoseconds
+    double sync;
+} cost_model_t;
+
+/**
+ * The settings of the program given on the command line.
+ */
+typedef struct settings {
+    // Input line of sight in the format x_1,x_2,...,x_n
+    char *line_of_sight;
+    // Path to the input binary profile, which is used instead of the line of sight
+    char *input;
+    // Path to the file with the line of sight, which is used instead of the line of sight on the command line
+    char *text;
+    // Path to the binary profile to write the input line of sight to
+    char *write_profile;
+    // Element type of the altitudes of the written binary profile (PROFILE_INT32 or PROFILE_INT16)
+    uint32_t element_type;
+    // Engine performing the max-prescan operation of the processor maximums (SCAN_TREE or SCAN_LOOKBACK)
+    int scan;
+    // Flag whether the fused pipeline computes the results without the shared windows of the angles
+    bool fused;
+    // Format of the written results (OUTPUT_TEXT, OUTPUT_RAW or OUTPUT_RLE)
+    int output;
+    // Flag whether the program serves the stream of the requests (one line of sight per line)
+    bool server;
+    // Path to the local socket of the server, the standard input is used when it is not given
+    char *socket;
+    // Flag whether the server keeps one growing line of sight changed by the commands of the requests
+    bool incremental;
+    // Index of the altitude, where the observer is placed (-1 when it is not given)
+    long long observer;
+    // Comma-separated indices of the observers of the batch (nullptr when the batch is not solved)
+    char *observers;
+    // Number of the cells within one row of the grid of the viewshed (0 for the line of sight)
+    long long grid_width;
+    // Cost model of the machine choosing the number of the participating processes
+    cost_model_t model;
+    // Flag whether the program only measures and writes out the cost model of the machine
+    bool calibrate;
+    // Number of the altitudes of the one tile of the out-of-core processing (0 when the profile is mapped whole)
+    long long tile;
+    // Number of the repetitions of each run of the benchmark (0 when the benchmark is not run)
+    int benchmark;
+    // Flag whether the telemetry of the phases of the processes is written out as the table
+    bool telemetry;
+    // Path to the trace file of the telemetry in the Chrome trace format (nullptr when it is not written)
+    char *trace;
+    // Placement of the pages of the shared windows (PLACEMENT_DEFAULT, PLACEMENT_LOCAL or PLACEMENT_HUGE)
+    int placement;
+    // Summary written out instead of the results of all points (SUMMARY_NONE, SUMMARY_INTERVALS, ...)
+    int summary;
+    // Number of the points between two samples of the horizon (only SUMMARY_HORIZON)
+    long long horizon_step;
+} settings_t;
+
+/**
+ * The status of the process within the single-pass max-prescan. Each process publishes
+ * the maximum of its window and subsequently the inclusive prefix, the flag is written
+ * after the published value with the release semantics. The status of the master process
+ * carries also the maximum of the preceding nodes. The status occupies the whole cache
+ * line, so the processes never write to the same line.
+ */
+typedef struct alignas(CACHE_LINE) scan_status {
+    // Published value of the process (STATUS_INVALID, STATUS_AGGREGATE or STATUS_PREFIX)
+    std::atomic<int> flag;
+    // Flag whether the maximum of the preceding nodes was published (only on the master process)
+    std::atomic<int> offset_flag;
+    // Maximum of the angles within the window of the process
+    slope_t aggregate;
+    // Maximum of the angles within the windows of the process and of all preceding processes on the node
+    slope_t inclusive;
+    // Maximum of the angles on the preceding nodes (only on the master process)
+    slope_t offset;
+} scan_status_t;
+
+/**
+ * The layout of the processes and of the processed altitudes. The processes are grouped
+ * to the nodes by the shared-memory sub-communicators and each node stores its contiguous
+ * part of the altitudes within its own shared windows. The master processes of the nodes
+ * (leaders) are connected by the inter-node communicator, through which only O(nodes)
+ * values are exchanged. All indices within the windows are relative to the node part.
+ */
+typedef struct layout {
+    // Communicator of the participating processes (MPI_COMM_WORLD unless some processes were parked)
+    MPI_Comm comm;
+    // Shared-memory communicator of the processes running on the same node
+    MPI_Comm node_comm;
+    // Communicator of the master processes of the nodes (MPI_COMM_NULL on the other processes)
+    MPI_Comm leaders_comm;
+    // Rank of the process in the communicator MPI_COMM_WORLD (equal to its rank within the participating ones)
+    int world_rank;
+    // Rank of the process in the node communicator
+    int rank;
+    // Size of the node communicator (number of the processes on the node)
+    int size;
+    // Number of the nodes
+    int nodes;
+    // Index of the node (rank of its master process in the leaders communicator)
+    int node;
+    // Position of the first process of the node within the sequence of all processes
+    int node_position;
+    // Number of the altitudes available within all processes
+    int total_altitudes;
+    // Index of the altitude, where the observer is placed
+    int observer;
+    // Index of the first altitude stored on the node with respect to the whole line of sight
+    int node_first;
+    // Number of the altitudes stored on the node
+    int node_count;
+    // Index of the first altitude of the process window within the node part
+    int start_idx;
+    // Number of the altitudes within the process window
+    int window_size;
+    // Placement of the pages of the shared windows (PLACEMENT_DEFAULT, PLACEMENT_LOCAL or PLACEMENT_HUGE)
+    int placement;
+    // Alignment of the node parts of the shared windows in bytes, the parts of the processes are aligned
+    // to it by the partition of the altitudes
+    size_t alignment;
+} layout_t;
+
+/**
+ * The shared windows used by the computation of the results. Within the server mode the
+ * windows are grow-only - they are allocated whole by the master process of the node for
+ * the given number of the altitudes (capacity) and reused by all following requests.
+ */
+typedef struct windows {
+    // Number of the altitudes of the node, which the grow-only windows are able to store (-1 before allocation)
+    int capacity;
+    // Window objects of the shared allocated windows
+    MPI_Win node_altitudes, node_angles, node_prev_angles, node_results, node_status;
+    // Shared allocated window of the altitudes (only the grow-only windows of the server)
+    int *shared_altitudes;
+    // Shared allocated windows of the computed angles and of the maximum previous angles
+    slope_t *shared_angles, *max_previous_angles;
+    // Shared allocated window of the statuses of the single-pass max-prescan
+    scan_status_t *status;
+    // Shared allocated bitset of the final results
+    uint64_t *result;
+} windows_t;
+
+/**
+ * The summary of the results merged on the master process from the partial summaries of
+ * all processes. The values are the pairs of the first and the last points of the visible
+ * intervals, the triplets of the index and of the slope (numerator, denominator) of the
+ * samples of the horizon, or the one value - the number of the visible points or the index
+ * of the furthest visible point (-1 when no point is visible).
+ */
+typedef struct summary {
+    // Values of the summary (valid only on the master process)
+    std::vector<long long> values;
+} summary_t;
+
+/**
+ * The stream of the requests of the server, which is read only by the master process.
+ * Each request is the one line with the line of sight and its response is the one line
+ * with the results. The requests are read either from the standard input or from the
+ * clients of the local socket, which are served one after another.
+ */
+typedef struct request_stream {
+    // Listening local socket (-1 when the standard input is used)
+    int listener;
+    // Descriptor of the currently read requests (-1 when no client is connected)
+    int input;
+    // Output of the responses of the currently read requests
+    FILE *output;
+    // Buffer of the read and not yet processed requests
+    std::vector<char> buffer;
+    // Number of the valid bytes within the buffer
+    size_t length;
+    // Flag whether the end of the input was reached
+    bool closed;
+} request_stream_t;
+
 /**
  * Loads the input line of sight in the specified format and individual numbers
  * convert to the integers and subsequently it stores them to the given vector.
  * The input is in the following format: x_1,x_2,...,x_n, where x_i in N for 1 <= i <= n
  * The result vector will contain the processed numbers: <x1, x2, ..., xn>.
  *
- * @param input_altitudes   input char sequence represents the points in the terrain (altitudes)
+ * @param text              input char sequence represents the points in the terrain (altitudes)
  * @param target_altitudes  output vector of the integer points in the terrain (altitudes)
  */
-void load_line_of_sight(char *input_altitudes, std::vector<int> *target_altitudes);
+void load_line_of_sight(const text_t *text, std::vector<int> *target_altitudes);
 
 /**
- * Computes the number of points which will be processed by the one process.
- * Allocates the shared memory for all process where will be stored the loaded
- * sequence of the altitudes. The master process copies the given vector to
- * the allocated shared memory.
+ * Parses the arguments given on the command line. The line of sight is the positional
+ * argument, the options are the following:
+ *  -s, --scan=tree|lookback    engine performing the max-prescan of the processor maximums
+ *  -i, --input=PROFILE         binary profile mapped by all processes instead of the line of sight
+ *  -t, --text=FILE             file with the line of sight mapped by all processes instead of the argument
+ *  -w, --write-profile=PROFILE converts the line of sight to the binary profile
+ *  -f, --fused                 computes the results in two passes without the shared windows of the angles
+ *  -o, --output=text|raw|rle   format of the written results
+ *  -S, --server                serves the lines of sight from the standard input, one response per line
+ *  -u, --socket=SOCKET         serves the lines of sight from the clients of the local socket
+ *  -x, --observer=OBSERVER     index of the altitude, where the observer is placed (the first one by default)
+ *  -I, --incremental           serves the commands growing the one line of sight, runs on the one process only
+ *  -g, --grid=WIDTH            computes the viewshed of the profile storing the grid of the given width by rows
+ *  -m, --model=POINT,SYNC      cost model (nanoseconds) choosing the participating processes, 0,0 keeps all
+ *  -C, --calibrate             measures the cost model of the machine and writes it out in the format of -m
+ *  -T, --tiled=TILE            streams the profile by the tiles of the given number of the altitudes
+ *  -b, --benchmark=REPETITIONS measures the phases of the generated lines of sight, writes out the JSON statistics
+ *  -r, --telemetry             writes out the phases, waits and window queries of each process to the error output
+ *  -R, --trace=TRACE           writes the phases of each process to the trace file in the Chrome trace event format
+ *  -e, --element=int32|int16   type of the altitudes stored by the written profile (-w), int32 by default
+ *  -P, --placement=local|huge  the owners place their parts of the windows (first touch), huge also on huge pages
+ *  -X, --observers=OBSERVERS   comma-separated observers, writes out the number of the visible points of each
+ *  -q, --summary=intervals|count|furthest|horizon[:STEP]
+ *                              writes out only the merged summary of the results instead of the results
+ *
+ * @param argc          number of the arguments on the command line
+ * @param argv          arguments on the command line
+ * @param settings      output settings of the program
+ * @return              true when the arguments are valid, otherwise false
+ */
+bool parse_arguments(int argc, char **argv, settings_t *settings);
+
+/**
+ * The master process writes out the given error to the standard error output.
+ *
+ * @param message       description of the error
+ * @param world_rank    rank of the process in a communicator MPI_COMM_WORLD
+ */
+void report_error(const char *message, int world_rank);
+
+/**
+ * Splits the processes to the nodes by the shared-memory sub-communicators and creates
+ * the communicator of the node masters. Computes the position of each node within the
+ * sequence of all processes, which determines the part of the altitudes of the node.
+ *
+ * @param layout    output layout of the processes (communicators, ranks and sizes), the communicator
+ *                  of the participating processes has to be set before
+ */
+void split_to_nodes(layout_t *layout);
+
+/**
+ * The masters of the nodes gather the numbers of the altitudes stored on each node and
+ * the indices of their first altitudes, which are used as the counts and displacements
+ * of the collective operations over the leaders communicator.
+ *
+ * @param counts            output vector of the numbers of the altitudes of the nodes (on the master process)
+ * @param displacements     output vector of the indices of the first altitudes of the nodes (on the master process)
+ * @param layout            layout of the processes and of the processed altitudes
+ */
+void gather_node_parts(std::vector<int> *counts, std::vector<int> *displacements, const layout_t *layout);
+
+/**
+ * User-defined MPI reduction operation computing the maximum of the slopes (MPI_User_function).
+ *
+ * @param in            input vector of the slopes
+ * @param inout         input and output vector of the slopes, the maximums are stored to it
+ * @param len           number of the slopes within the vectors
+ * @param datatype      datatype of the elements of the vectors (MPI_2INT)
+ */
+void slope_max_operation(void *in, void *inout, int *len, MPI_Datatype *datatype);
+
+/**
+ * Computes the part of the altitudes, which will be processed by the process at the
+ * given position within the sequence of all processes. The altitudes are distributed
+ * equally by the whole units of the given number of the altitudes (whole words of the
+ * bitset of the results), the first (u mod p) processes process one unit more than the
+ * others. Thus each process writes only its own words and its part of each shared window
+ * starts at the aligned address.
  *
- * @param shared_altitudes  shared window object used for communication (initial address) - handle
- * @param node_altitudes    window node of each process - initial address of the process window (choice)
- * @param window_size       size of the process window in bytes (non-negative integer)
  * @param total_altitudes   number of the altitudes available within all processes
- * @param size              size of a communicator MPI_COMM_WORLD (number of the processes)
- * @param altitudes         vector of the loaded altitudes
- * @param rank              rank of the process in a communicator MPI_COMM_WORLD
+ * @param processes         number of all processes
+ * @param position          position of the process within the sequence of all processes
+ * @param unit              number of the altitudes of one unit (multiple of WORD_BITS, see ALIGN_POINTS)
+ * @return                  index of the first altitude processed by the process at the given position
+ */
+int partition_points(int total_altitudes, int processes, int position, size_t unit);
+
+/**
+ * Queries the base pointer of the node part of the shared window, which starts at the first
+ * address of the part of the master process aligned to the given alignment. The processes
+ * map the window at the different addresses, thus the alignment is limited to the page.
+ *
+ * @param win           shared memory window object
+ * @param alignment     alignment of the node part in bytes (power of two)
+ * @return              aligned base pointer of the node part
+ */
+void *query_node_base(MPI_Win win, size_t alignment);
+
+/**
+ * Allocates the shared window of the node part. The whole node part is allocated by the
+ * master process together with the padding to its aligned base (see query_node_base), thus the node part is
+ * contiguous and aligned for any sizes of the parts of the processes. Within the placement
+ * PLACEMENT_LOCAL each process touches its own part first, thus its pages are placed on the
+ * NUMA node of the process, within the placement PLACEMENT_HUGE the pages are also advised
+ * to be backed by the transparent huge pages.
+ *
+ * @param count         number of the elements of the node part (equal on all processes of the node)
+ * @param unit          size of one element in bytes
+ * @param first         index of the first element of the part of the calling process
+ * @param own           number of the elements of the part of the calling process
+ * @param layout        layout of the processes (the node communicator, the placement and the alignment)
+ * @param win           output shared memory window object
+ * @return              aligned base pointer of the node part
+ */
+void *allocate_node_window(size_t count, size_t unit, size_t first, size_t own, const layout_t *layout, MPI_Win *win);
+
+/**
+ * Computes the number of points which will be processed by each process and by each node.
+ * Each node obtains the contiguous part of the altitudes, which consists of the parts of
+ * all its processes.
+ *
+ * @param layout            layout of the processes, the parts of the altitudes are stored to it
+ */
+void assign_points_to_process(layout_t *layout);
+
+/**
+ * Each process obtains the input line of sight, either directly the positional argument
+ * (the command line is available to all processes) or the file mapped by each process.
+ *
+ * @param settings          settings of the program given on the command line
+ * @param text              output line of sight
+ * @param world_rank        rank of the process in a communicator MPI_COMM_WORLD
+ * @return                  true when all processes obtained the line of sight, otherwise false
+ */
+bool open_line_of_sight(const settings_t *settings, text_t *text, int world_rank);
+
+/**
+ * Computes the number of the altitudes of the text by the parallel counting: each process
+ * counts the altitudes starting within its equal byte range of the text and the counts of
+ * all ranges are exchanged to find the index of the first altitude of each range. Then it
+ * assigns the relevant number of the altitudes to each process.
+ *
+ * @param text              input line of sight available to all processes
+ * @param firsts            output indices of the first altitudes starting within the byte ranges
+ * @param observer_altitude output altitude of the observer (the first altitude of the line of sight)
+ * @param layout            layout of the processes, the parts of the altitudes are stored to it
+ * @return                  true when the line of sight contains the supported number of the altitudes
+ */
+bool count_points_to_process(
+    const text_t *text, std::vector<long long> *firsts, int *observer_altitude, layout_t *layout
+);
+
+/**
+ * Each process parses only the altitudes of its own window directly to the shared memory.
+ *
+ * @param shared_altitudes  shared allocated window of the altitudes (initial address of the node part)
+ * @param text              input line of sight available to all processes
+ * @param firsts            indices of the first altitudes starting within the byte ranges
+ * @param layout            layout of the processes and of the processed altitudes
+ */
+void parse_points_to_process(
+    int *shared_altitudes, const text_t *text, const std::vector<long long> *firsts, const layout_t *layout
+);
+
+/**
+ * Allocates the shared memory for all process of the node where will be stored the node
+ * part of the sequence of the altitudes. The text is parsed in parallel from the byte
+ * ranges counted before (see count_points_to_process and parse_points_to_process), thus
+ * no process holds the whole parsed line of sight.
+ *
+ * @param shared_altitudes  shared window object used for communication (initial address of the node part)
+ * @param node_altitudes    window node of each process - initial address of the process window (choice)
+ * @param text              input line of sight available to all processes
+ * @param firsts            indices of the first altitudes starting within the byte ranges
+ * @param layout            layout of the processes and of the processed altitudes
  */
 void share_points_to_process(
-    int **shared_altitudes, MPI_Win *node_altitudes, MPI_Aint *window_size, int total_altitudes, int size,
-    std::vector<int> altitudes, int rank
+    int **shared_altitudes, MPI_Win *node_altitudes, const text_t *text, const std::vector<long long> *firsts,
+    const layout_t *layout
 );
 
 /**
- * Computes the relevant index of each process, where start its window with respect
- * to the whole shared allocated window. Queries the size and base pointer for a
- * patch of shared memory windows to obtain all required data for computation.
- * Each process computes own part of the angles from the given altitudes and stores
- * them at the relevant index to the resulting shared window.
+ * Chooses the number of the participating processes with the lowest runtime estimated by
+ * the given cost model. The single process means the sequential sweep of the altitudes.
+ * The equal runtimes are broken by the more processes, thus the zero model (-m 0,0) keeps
+ * all of them.
  *
- * @param shared_altitudes      shared allocated window containing the loaded altitudes
+ * @param total_altitudes   number of the altitudes of the line of sight
+ * @param processes         number of all available processes
+ * @param model             cost model of the machine
+ * @return                  number of the participating processes
+ */
+int schedule_processes(long long total_altitudes, int processes, const cost_model_t *model);
+
+/**
+ * Parks the surplus processes, the participating ones are the processes with the lowest
+ * ranks. The participating processes create their own communicator and split it to the
+ * nodes again, thus the parked processes join none of their collective operations.
+ *
+ * @param active            number of the participating processes
+ * @param layout            layout of the processes, the communicators are replaced by the new ones
+ * @return                  true when the process participates, false when it was parked
+ */
+bool park_processes(int active, layout_t *layout);
+
+/**
+ * Measures the cost model of the machine. The master process sweeps CALIBRATION_POINTS
+ * altitudes and all processes measure CALIBRATION_BARRIERS barriers, the time of one
+ * barrier is divided by the number of the levels of the tree of all processes.
+ *
+ * @param model             output cost model of the machine
+ * @param layout            layout of the processes
+ */
+void calibrate_cost_model(cost_model_t *model, const layout_t *layout);
+
+/**
+ * Maps the given binary profile by each process, so each process reads its part of the
+ * altitudes directly from the file, without any parsing and copying. The place of the
+ * observer and its altitude are read from the profile.
+ *
+ * @param path                  path to the file with the binary profile
+ * @param profile               output mapped profile
+ * @param observer_altitude     output altitude of the observer
+ * @param layout                layout of the processes, the number of the altitudes is stored to it
+ * @return                      true when all processes mapped the profile, otherwise false
+ */
+bool map_profile(const char *path, profile_t *profile, int *observer_altitude, layout_t *layout);
+
+/**
+ * Queries the size and base pointer for a patch of shared memory windows to obtain all
+ * required data for computation. Each process computes own part of the angles from the
+ * given altitudes and stores them at the relevant index to the resulting shared window.
+ *
+ * @param altitudes             altitudes of the node part (shared allocated window or mapped profile)
  * @param shared_angles         shared allocated window to store newly computed angles from altitudes
  * @param max_previous_angles   shared allocated window to store newly computed angles from altitudes (for max-prescan)
- * @param node_altitudes        window object of each process to the shared allocated window of stored altitudes
  * @param node_angles           window object of each process to the shared allocated window of computed angles
  * @param node_prev_angles      window object of each process to the shared allocated window of previous angles
- * @param window_size           size of the process window in bytes (non-negative integer)
- * @param disp_unit             local unit size for displacements, in bytes (non-negative integer)
- * @param total_altitudes       number of the altitudes available within all processes
- * @param size                  size of a communicator MPI_COMM_WORLD (number of the processes)
- * @param rank                  rank of the process in a communicator MPI_COMM_WORLD
+ * @param observer_altitude     altitude of the observer (the first altitude of the line of sight)
+ * @param layout                layout of the processes and of the processed altitudes
  */
+template <typename altitude_t>
 void compute_angles(
-    int **shared_altitudes, float **shared_angles, float **max_previous_angles, MPI_Win node_altitudes, MPI_Win
-    node_angles, MPI_Win node_prev_angles, MPI_Aint window_size, int disp_unit, int total_altitudes, int size, int rank
+    const altitude_t *altitudes, slope_t **shared_angles, slope_t **max_previous_angles, MPI_Win node_angles,
+    MPI_Win node_prev_angles, int observer_altitude, const layout_t *layout
 );
 
 /**
  * Performs the max-prescan operation on the given vector of the computed angles. Firstly,
- * it performs the up-sweep phase of this operation, then the master stores the neutral
- * element to the root of the processing tree and then are performed down-sweep phase.
+ * it performs the up-sweep phase of this operation, then the master stores the given
+ * identity to the root of the processing tree and then are performed down-sweep phase.
+ * The identity is the neutral element, or the maximum of the preceding nodes, which is
+ * thus propagated to all elements of the vector.
  *
  * @param shared_angles         shared allocated window containing the computed angles from altitudes
  * @param node_angles           window object of each process to the shared allocated window of previous angles
- * @param window_size           size of the process window in bytes (non-negative integer)
- * @param disp_unit             local unit size for displacements, in bytes (non-negative integer)
- * @param total_angles          number of the altitudes available within all processes
- * @param size                  size of a communicator MPI_COMM_WORLD (number of the processes)
- * @param rank                  rank of the process in a communicator MPI_COMM_WORLD
+ * @param identity              value set to the root of the tree (the neutral element or the offset)
+ * @param stride                number of the slopes between two consecutive elements of the vector
+ * @param total_angles          number of the angles within the processed vector
+ * @param rank                  rank of the process in a node communicator
+ * @param layout                layout of the processes (the node communicator and the alignment of the window)
  */
 void max_prescan(
-    float **shared_angles, MPI_Win node_angles, MPI_Aint window_size, int disp_unit, int total_angles, int size, int rank
+    slope_t **shared_angles, MPI_Win node_angles, slope_t identity, int stride, int total_angles, int rank,
+    const layout_t *layout
 );
 
+/**
+ * The masters of the nodes perform the inter-node exclusive max-scan of the maximums of
+ * their nodes, thus only one value per node is sent. On the first node (and when there is
+ * only one node) the result is the neutral element.
+ *
+ * @param node_max      maximum of all angles on the node of the calling master process
+ * @param layout        layout of the processes and of the processed altitudes
+ * @return              maximum of all angles on the preceding nodes
+ */
+slope_t node_exclusive_max(slope_t node_max, const layout_t *layout);
+
+/**
+ * Each processor prescan self n/p section of the angles vector. The first angle of the
+ * window obtains the given offset, each next one the maximum of the offset and of the
+ * preceding angles within the window.
+ *
+ * @param shared_angles         vector of the angles with the base at the begin of the node part
+ * @param offset                maximum of all angles preceding the window of the process
+ * @param layout                layout of the processes and of the processed altitudes
+ */
+void prescan_window(slope_t *shared_angles, slope_t offset, const layout_t *layout);
+
+/**
+ * The masters of the nodes combine the given maximums of the processors by the inter-node
+ * exclusive max-scan, then the tree technique is used to max-prescan the processor maximums
+ * within each node, with the result of the inter-node scan as the identity. The maximums
+ * are stored within the temporary shared window, which is freed before the return.
+ *
+ * @param window_max            maximum of the angles within the window of the process
+ * @param layout                layout of the processes and of the processed altitudes
+ * @return                      maximum of all angles preceding the window of the process
+ */
+slope_t window_offset(slope_t window_max, const layout_t *layout);
+
 /**
  *  Each processor first find the maximum within self n/p section of the angles vector to
- *  generate a processor maximum, then the tree technique is used to max-prescan the
- *  processor sums. The results of the max-prescan of the processor maximums are used
- *  as an offset for each processor to prescan within its n/p section.
+ *  generate a processor maximum. The processor maximums are max-prescanned (see window_offset)
+ *  and the results are used as an offset for each processor to prescan within its n/p section.
  *
  * @param shared_angles         shared allocated window containing the computed angles from altitudes
  * @param node_angles           window object of each process to the shared allocated window of previous angles
- * @param window_size           size of the process window in bytes (non-negative integer)
- * @param disp_unit             local unit size for displacements, in bytes (non-negative integer)
- * @param total_angles          number of the altitudes available within all processes
- * @param size                  size of a communicator MPI_COMM_WORLD (number of the processes)
- * @param rank                  rank of the process in a communicator MPI_COMM_WORLD
- */
-void preprocess_subsets(
-    float **shared_angles, MPI_Win node_angles, MPI_Aint window_size, int disp_unit, int total_angles, int size, int rank
+ * @param layout                layout of the processes and of the processed altitudes
+ */
+void preprocess_subsets(slope_t **shared_angles, MPI_Win node_angles, const layout_t *layout);
+
+/**
+ * Each process initializes its status within the single-pass max-prescan and waits
+ * until all statuses of the node are initialized.
+ *
+ * @param status        shared allocated window of the statuses of the processes
+ * @param comm          node communicator of the processes sharing the window
+ */
+void init_scan_status(scan_status_t *status, MPI_Comm comm);
+
+/**
+ *  Each processor publishes the given maximum of its n/p section to its status. Then it
+ *  looks back at the statuses of its predecessors and combines their published maximums
+ *  until it finds the inclusive prefix, which it also publishes. Thus the max-prescan of
+ *  the processor maximums is computed in one pass without any global barrier. The master
+ *  of each node waits for the maximum of the whole node, performs the inter-node exclusive
+ *  max-scan and publishes its result as the offset of the node.
+ *
+ * @param window_max            maximum of the angles within the window of the process
+ * @param status                shared allocated window of the statuses of the processes
+ * @param node_status           window object of each process to the shared allocated window of the statuses
+ * @param layout                layout of the processes and of the processed altitudes
+ * @return                      maximum of all angles preceding the window of the process
+ */
+slope_t lookback_offset(slope_t window_max, scan_status_t **status, MPI_Win node_status, const layout_t *layout);
+
+/**
+ *  Each processor first find the maximum within self n/p section of the angles vector and
+ *  obtains the maximum of all preceding angles by the single-pass look-back (see
+ *  lookback_offset). The results are used as an offset for each processor to prescan
+ *  within its n/p section.
+ *
+ * @param shared_angles         shared allocated window containing the computed angles from altitudes
+ * @param status                shared allocated window of the statuses of the processes
+ * @param node_angles           window object of each process to the shared allocated window of previous angles
+ * @param node_status           window object of each process to the shared allocated window of the statuses
+ * @param layout                layout of the processes and of the processed altitudes
+ */
+void lookback_prescan(
+    slope_t **shared_angles, scan_status_t **status, MPI_Win node_angles, MPI_Win node_status,
+    const layout_t *layout
 );
 
 /**
- * Computes the relevant index of each process, where start its window with respect
- * to the whole shared allocated window. Queries the size and base pointer for a
- * patch of shared memory windows to obtain all required data for computation.
- * Each process computes own part of the results from the given data and stores
- * them to the final shared allocated window at the relevant index.
+ * Queries the size and base pointer for a patch of shared memory windows to obtain all
+ * required data for computation. Each process computes own part of the results from
+ * the given data and stores them to the final shared allocated window at the relevant index.
  *
  * @param shared_angles         shared allocated window containing the computed angles from altitudes
  * @param max_previous_angles   shared allocated window containing the computed previous angles with max-prescan
- * @param result                shared allocated window to store the results of the subtraction of angles and previous
+ * @param result                shared allocated bitset to store the results of the subtraction of angles and previous
  * @param node_angles           window object of each process to the shared allocated window of computed angles
  * @param node_prev_angles      window object of each process to the shared allocated window of previous angles
  * @param node_results          window object of each process to the shared allocated window of final results
- * @param disp_unit             local unit size for displacements, in bytes (non-negative integer)
- * @param window_size           size of the process window in bytes (non-negative integer)
- * @param total_angles          number of the altitudes available within all processes
- * @param size                  size of a communicator MPI_COMM_WORLD (number of the processes)
- * @param rank                  rank of the process in a communicator MPI_COMM_WORLD
+ * @param layout                layout of the processes and of the processed altitudes
  */
 void compute_results(
-    float **shared_angles, float **max_previous_angles, bool **result, MPI_Win node_angles, MPI_Win node_prev_angles,
-    MPI_Win node_results, int disp_unit, int window_size, int total_angles, int size, int rank
+    slope_t **shared_angles, slope_t **max_previous_angles, uint64_t **result, MPI_Win node_angles,
+    MPI_Win node_prev_angles, MPI_Win node_results, const layout_t *layout
 );
 
 /**
- * The master process write out to the standard output the final results based on the
- * given shared allocated window of the computed results.
+ * Computes the maximum of the angles within all windows following the window of the
+ * process by the exclusive max-scan over the processes in the reverse order.
+ *
+ * @param window_max            maximum of the angles within the window of the process
+ * @param layout                layout of the processes and of the processed altitudes
+ * @return                      maximum of all angles following the window of the process
+ */
+slope_t suffix_offset(slope_t window_max, const layout_t *layout);
+
+/**
+ * Computes the final results directly from the altitudes in two passes over the window of
+ * each process. The altitudes after the observer are swept forward and the altitudes before
+ * the observer backward, both within the same passes. The first pass finds the maximum
+ * angles of both parts of the window, which are combined with the maximums of the other
+ * processes - the forward ones by the selected engine and the backward ones by the reverse
+ * exclusive max-scan. The second pass computes the angles, their running maximums from the
+ * obtained offsets and the results at once. The angles are computed by the cache-sized
+ * blocks, thus no shared window of the angles or of the maximum previous angles is needed.
+ *
+ * @param altitudes             altitudes of the node part (shared allocated window or mapped profile)
+ * @param result                shared allocated bitset to store the final results
+ * @param status                shared allocated window of the statuses of the processes (only SCAN_LOOKBACK)
+ * @param node_results          window object of each process to the shared allocated window of final results
+ * @param node_status           window object of each process to the shared allocated window of the statuses
+ * @param observer_altitude     altitude of the observer
+ * @param scan                  engine combining the maximums of the processes (SCAN_TREE or SCAN_LOOKBACK)
+ * @param layout                layout of the processes and of the processed altitudes
+ */
+template <typename altitude_t>
+void fused_results(
+    const altitude_t *altitudes, uint64_t **result, scan_status_t **status, MPI_Win node_results, MPI_Win node_status,
+    int observer_altitude, int scan, const layout_t *layout
+);
+
+/**
+ * All processes obtain the altitude of the observer from the process, which window
+ * contains the observer.
+ *
+ * @param node_part             altitudes of the node part (shared allocated window or mapped profile)
+ * @param layout                layout of the processes and of the processed altitudes
+ * @return                      altitude of the observer
+ */
+int observer_altitude_of(const int *node_part, const layout_t *layout);
+
+/**
+ * Allocates the shared windows of the angles, of the statuses and of the final results,
+ * each process allocates its own part of the windows.
  *
- * @param result            shared allocated window of stored results of the subtraction of angles and previous angles
+ * @param windows           output shared windows
+ * @param settings          settings of the program given on the command line
+ * @param layout            layout of the processes and of the processed altitudes
+ */
+void allocate_windows(windows_t *windows, const settings_t *settings, const layout_t *layout);
+
+/**
+ * Frees the shared windows of the angles, of the statuses and of the final results.
+ *
+ * @param windows           shared windows
+ * @param settings          settings of the program given on the command line
+ */
+void free_windows(windows_t *windows, const settings_t *settings);
+
+/**
+ * Computes the maximum previous angles of the computed angles by the engine selected by
+ * the given settings: the single-pass look-back, the pre-processing of the subsets with
+ * the max-prescan of their maximums or the max-prescan of all angles itself.
+ *
+ * @param windows               shared windows with the computed angles
+ * @param settings              settings of the program given on the command line
+ * @param layout                layout of the processes and of the processed altitudes
+ */
+void prescan_angles(windows_t *windows, const settings_t *settings, const layout_t *layout);
+
+/**
+ * Computes the final results of the single participating process by the sequential sweep
+ * of the altitudes from the observer to both ends of the line of sight. No angles and no
+ * synchronisation are needed.
+ *
+ * @param altitudes             all altitudes of the line of sight
+ * @param result                output bitset of the results of all altitudes
+ * @param observer_altitude     altitude of the observer
+ * @param layout                layout of the processes and of the processed altitudes
+ */
+template <typename altitude_t>
+void sequential_results(const altitude_t *altitudes, uint64_t *result, int observer_altitude, const layout_t *layout);
+
+/**
+ * Computes the final results of the line-of-sight problem by the pipeline and by the
+ * engine selected by the given settings. The results are stored to the shared window
+ * of the results of each node.
+ *
+ * @param node_part             altitudes of the node part (shared allocated window or mapped profile)
+ * @param windows               shared windows used by the computation
+ * @param observer_altitude     altitude of the observer (the first altitude of the line of sight)
+ * @param settings              settings of the program given on the command line
+ * @param layout                layout of the processes and of the processed altitudes
+ */
+template <typename altitude_t>
+void solve_line_of_sight(
+    const altitude_t *node_part, windows_t *windows, int observer_altitude, const settings_t *settings,
+    const layout_t *layout
+);
+
+/**
+ * Computes the final results of the line-of-sight problem by the specialization of the
+ * pipeline for the given element type of the stored altitudes.
+ *
+ * @param node_part             altitudes of the node part (shared allocated window or mapped profile)
+ * @param element_type          element type of the altitudes (PROFILE_INT32 or PROFILE_INT16)
+ * @param windows               shared windows used by the computation
+ * @param observer_altitude     altitude of the observer
+ * @param settings              settings of the program given on the command line
+ * @param layout                layout of the processes and of the processed altitudes
+ */
+void solve_node_part(
+    const void *node_part, uint32_t element_type, windows_t *windows, int observer_altitude,
+    const settings_t *settings, const layout_t *layout
+);
+
+/**
+ * Gathers the results of all nodes to the master process. When all processes run on the
+ * one node, the master process only queries the shared window, otherwise the masters of
+ * the nodes send the whole words of their parts of the bitset to the master process.
+ *
+ * @param result            shared allocated bitset of the node results, on the master it is set to all results
  * @param node_results      window object of each process to the shared allocated window of final results
- * @param window_size       size of the process window in bytes (non-negative integer)
- * @param disp_unit         local unit size for displacements, in bytes (non-negative integer)
- * @param total_points      number of the altitudes available within all processes
+ * @param gathered          vector to store the results of all nodes (used only on the master process)
+ * @param layout            layout of the processes and of the processed altitudes
+ */
+void gather_results(
+    uint64_t **result, MPI_Win node_results, std::vector<uint64_t> *gathered, const layout_t *layout
+);
+
+/**
+ * The master process write out to the standard output the final results based on the
+ * given results of all altitudes in the selected format.
+ *
+ * @param result            bitset of the results of all altitudes
+ * @param total_altitudes   number of the altitudes available within all processes
+ * @param observer          index of the altitude, where the observer is placed
+ * @param output            format of the written results (OUTPUT_TEXT, OUTPUT_RAW or OUTPUT_RLE)
+ * @return                  true when the results were written, otherwise false
+ */
+bool write_out_result(const uint64_t *result, int total_altitudes, int observer, int output);
+
+/**
+ * The master process opens the stream of the requests, either the standard input or the
+ * listening local socket at the given path.
+ *
+ * @param path          path to the local socket (nullptr for the standard input)
+ * @param stream        output stream of the requests
+ * @return              nullptr when the stream was opened, otherwise the description of the error
+ */
+const char *open_request_stream(const char *path, request_stream_t *stream);
+
+/**
+ * The master process reads the next batch of the requests, which consists of all complete
+ * lines currently read from the input of the one client. It blocks until at least one line
+ * is available or until the end of the stream.
+ *
+ * @param stream        stream of the requests
+ * @param batch         output batch of the requests, each of them is terminated by the new line
+ * @return              true when the batch was read, false at the end of the stream
+ */
+bool read_request_batch(request_stream_t *stream, std::vector<char> *batch);
+
+/**
+ * The master process closes the stream of the requests.
+ *
+ * @param stream        stream of the requests
+ * @param path          path to the local socket (nullptr for the standard input)
+ */
+void close_request_stream(request_stream_t *stream, const char *path);
+
+/**
+ * Reserves the grow-only shared windows for the current layout of the altitudes. The windows
+ * are reallocated only when the node part does not fit to them, their capacity is at least
+ * doubled, thus the allocation is amortized over the stream of the requests. The windows are
+ * allocated whole by the master process of the node, thus the node part is contiguous for
+ * any capacity.
+ *
+ * @param windows           grow-only shared windows
+ * @param settings          settings of the program given on the command line
+ * @param layout            layout of the processes and of the processed altitudes
+ */
+void reserve_windows(windows_t *windows, const settings_t *settings, const layout_t *layout);
+
+/**
+ * Frees the grow-only shared windows, when they were allocated.
+ *
+ * @param windows           grow-only shared windows
+ * @param settings          settings of the program given on the command line
+ */
+void release_windows(windows_t *windows, const settings_t *settings);
+
+/**
+ * Processes the one batch of the requests broadcast to all processes. The long lines of
+ * sight are split to all processes and processed one after another within the grow-only
+ * windows. The short lines of sight are distributed whole to the processes (the least
+ * loaded process obtains the next one) and each process processes them sequentially by
+ * the fused kernel. The master process writes out the responses in the order of the batch.
+ *
+ * @param batch             batch of the requests, each of them is terminated by the new line
+ * @param windows           grow-only shared windows
+ * @param output            output of the responses (used only on the master process)
+ * @param settings          settings of the program given on the command line
+ * @param layout            layout of the processes and of the processed altitudes
+ */
+void serve_batch(
+    const std::vector<char> *batch, windows_t *windows, FILE *output, const settings_t *settings, layout_t *layout
+);
+
+/**
+ * Runs the server, which keeps the processes and the shared windows alive across the stream
+ * of the requests. The master process reads the batches of the requests and broadcasts them
+ * to all processes until the end of the stream.
+ *
+ * @param settings          settings of the program given on the command line
+ * @param layout            layout of the processes and of the processed altitudes
+ * @return                  exit code of the program
+ */
+int serve_requests(const settings_t *settings, layout_t *layout);
+
+/**
+ * Executes the command of the incremental server on the kept line of sight and writes out
+ * its response. The command "+x_1,x_2,...,x_k" appends the altitudes and responds with the
+ * number of all altitudes, "=INDEX,ALTITUDE" changes one altitude and responds with the
+ * number of the recomputed blocks and "?" responds with the results in the selected format.
+ * The invalid command has the empty response.
+ *
+ * @param line              command of the request without the new line
+ * @param length            length of the command in bytes
+ * @param engine            incremental engine keeping the line of sight
+ * @param output            output of the response
+ * @param settings          settings of the program given on the command line
+ */
+void serve_command(const char *line, size_t length, incremental_t *engine, FILE *output, const settings_t *settings);
+
+/**
+ * Runs the incremental server, which keeps one line of sight growing by the commands of
+ * the requests. Each command costs the work proportional to the changed part of the line
+ * of sight only, thus the server runs on the one process, the more processes are rejected.
+ *
+ * @param settings          settings of the program given on the command line
+ * @param layout            layout of the processes and of the processed altitudes
+ * @return                  exit code of the program
+ */
+int serve_incremental(const settings_t *settings, layout_t *layout);
+
+/**
+ * Counts the rays of the viewshed, which are cast from the observer to all cells of the
+ * border of the grid.
+ *
+ * @param width             number of the cells within one row of the grid
+ * @param height            number of the rows of the grid
+ * @return                  number of the rays of the viewshed
+ */
+long long count_rays(int width, int height);
+
+/**
+ * Finds the cell of the border of the grid, where the given ray ends. The rays are ordered
+ * by the top row, the bottom row and by the first and the last cell of the other rows.
+ *
+ * @param width             number of the cells within one row of the grid
+ * @param height            number of the rows of the grid
+ * @param ray               index of the ray (less than the number of the rays)
+ * @return                  index of the target cell of the ray within the grid
+ */
+int ray_target(int width, int height, long long ray);
+
+/**
+ * Samples the altitudes of the grid along the ray from the observer to the target cell.
+ * The ray moves by one cell along its longer axis per step, the other coordinate is
+ * rounded to the nearest cell. The first sample is the cell of the observer.
+ *
+ * @param grid              altitudes of the grid stored by the rows
+ * @param width             number of the cells within one row of the grid
+ * @param observer          index of the cell of the observer
+ * @param target            index of the target cell of the ray
+ * @param altitudes         output altitudes of the samples
+ * @param cells             output indexes of the cells of the samples within the grid
+ * @return                  number of the samples of the ray
+ */
+size_t sample_ray(
+    const int *grid, int width, int observer, int target, std::vector<int> *altitudes, std::vector<int> *cells
+);
+
+/**
+ * Parses the comma-separated list of the indices of the observers of the batch.
+ *
+ * @param list          comma-separated list of the non-negative indices
+ * @param observers     output vector of the indices of the observers in the order of the list
+ * @return              true when the list is valid, otherwise false
+ */
+bool parse_observers(const char *list, std::vector<long long> *observers);
+
+/**
+ * Solves the line of sight of each observer of the batch over the altitudes loaded once.
+ * The observers are solved by the blocks of BATCH_BLOCK observers, each process sweeps
+ * all observers of the block over each tile of BATCH_TILE altitudes of its window, thus
+ * the window is streamed from the memory once per the pass of the block instead of once
+ * per the observer. The master process writes out the number of the visible points of
+ * each observer (text) or the bitset of each observer (raw) in the order of the list.
+ *
+ * @param node_part         altitudes of the node part (shared allocated window or mapped profile)
+ * @param element_type      element type of the altitudes (PROFILE_INT32 or PROFILE_INT16)
+ * @param settings          settings of the program given on the command line
+ * @param layout            layout of the processes and of the processed altitudes
+ * @return                  exit code of the program
+ */
+int solve_observers(const void *node_part, uint32_t element_type, const settings_t *settings, const layout_t *layout);
+
+/**
+ * Parses the kind of the summary in the format intervals|count|furthest|horizon[:STEP].
+ *
+ * @param kind          kind of the summary given on the command line
+ * @param settings      output settings with the kind of the summary and the step of the horizon
+ * @return              true when the kind is valid, otherwise false
+ */
+bool parse_summary(const char *kind, settings_t *settings);
+
+/**
+ * Each process summarizes its own window of the results (and of the angles for the horizon)
+ * and the partial summaries are merged on the master process. The intervals are joined across
+ * the borders of the windows, the numbers are summed and the furthest points are reduced, thus
+ * only O(p + size of the summary) values are gathered. The horizon needs the shared windows of
+ * the angles and of the maximum previous angles of the not fused pipeline.
+ *
+ * @param windows       shared windows of the computed pipeline
+ * @param settings      settings of the program given on the command line
+ * @param summary       output summary (valid only on the master process)
+ * @param layout        layout of the processes and of the processed altitudes
+ */
+void summarize_results(const windows_t *windows, const settings_t *settings, summary_t *summary, const layout_t *layout);
+
+/**
+ * Writes out the summary - one visible interval (its first and last point) per line, one
+ * sample of the horizon (its index and the tangent of the angle) per line, or the one value.
+ *
+ * @param file          output file (e.g. the standard output)
+ * @param summary       merged summary of the results
+ * @param settings      settings of the program given on the command line
+ * @return              true when the summary was written, otherwise false
+ */
+bool write_summary(FILE *file, const summary_t *summary, const settings_t *settings);
+
+/**
+ * Computes the viewshed of the observer over the grid stored within the binary profile.
+ * The rays are assigned to the processes by the chunks of VIEWSHED_CHUNK rays through
+ * the shared counter, each ray is solved as the line of sight of its samples, where the
+ * step along the ray is the distance of the sample. The master process combines the
+ * visibilities of all processes and writes out the bit raster.
+ *
+ * @param settings          settings of the program given on the command line
+ * @param layout            layout of the processes and of the processed altitudes
+ * @return                  exit code of the program
+ */
+int compute_viewshed(const settings_t *settings, layout_t *layout);
+
+/**
+ * Sweeps the one tile of the out-of-core processing. The tiles, which distances from the
+ * observer fit to the int, are swept by the sweep_slopes kernel, the further tiles by the
+ * kernel with the wide slopes. Both compare the slopes with their running maximum element
+ * by element in the scalar loop, only the slopes of the near tiles are computed by the
+ * vectorized compute_slopes.
+ *
+ * @param altitudes             altitudes of the tile
+ * @param observer_altitude     altitude of the observer
+ * @param first                 index of the first altitude of the tile (its distance from the observer)
+ * @param count                 number of the altitudes of the tile
+ * @param running               maximum of the slopes of all preceding tiles
+ * @param result                output bitset of the results of the tile (zero before)
+ * @return                      maximum of the slopes up to the end of the tile
+ */
+wide_slope_t sweep_tile(
+    const int *altitudes, int observer_altitude, uint64_t first, size_t count, wide_slope_t running,
+    uint64_t *result
+);
+
+/**
+ * Processes the binary profile by the tiles of the given size with the bounded memory.
+ * The master process reads the next tile asynchronously during the sweep of the current
+ * one and writes out the results of each tile as soon as it is swept.
+ *
+ * @param settings          settings of the program given on the command line
+ * @param layout            layout of the processes
+ * @return                  exit code of the program
+ */
+int process_tiles(const settings_t *settings, const layout_t *layout);
+
+/**
+ * Generates the synthetic line of sight of the given terrain in the comma-separated format.
+ *
+ * @param terrain           generated terrain (TERRAIN_RANDOM, TERRAIN_MONOTONE or TERRAIN_WORST)
+ * @param total_altitudes   number of the generated altitudes
+ * @param line              output line of sight
+ */
+void generate_terrain(int terrain, int total_altitudes, std::string *line);
+
+/**
+ * Runs all phases of the pipeline once and measures them. Each phase ends by the barrier
+ * of all participating processes, thus the measured time is the time of the slowest one.
+ *
+ * @param text              line of sight available to all processes
+ * @param settings          settings of the program given on the command line
+ * @param layout            layout of the participating processes
+ * @param times             output times of the phases in microseconds (indexed by PHASE_*)
+ */
+void benchmark_pipeline(
+    const text_t *text, const settings_t *settings, layout_t *layout, std::vector<double> *times
+);
+
+/**
+ * Measures the bandwidth of the reads of the processes from their own regions of the shared
+ * window, whose pages are touched first either by their owners (local placement) or by all
+ * processes of the node in the round-robin order of the pages (interleaved placement).
+ *
+ * @param interleaved       flag whether the pages are interleaved over the processes of the node
+ * @param layout            layout of the participating processes
+ * @return                  bandwidth of the reads of all processes in GB/s
+ */
+double placement_bandwidth(bool interleaved, const layout_t *layout);
+
+/**
+ * Runs the benchmark of all synthetic terrains, of all sizes and of the power-of-two numbers
+ * of the processes. The master process writes out the median and the 99th percentile of the
+ * time of each phase and the bandwidth of the local and of the interleaved placement of the
+ * pages as the JSON document.
+ *
+ * @param settings          settings of the program given on the command line
+ * @param layout            layout of the processes
+ * @return                  exit code of the program
  */
-void write_out_result(bool **result, MPI_Win node_results, MPI_Aint window_size, int disp_unit, int total_altitudes);
\ No newline at end of file
+int run_benchmark(const settings_t *settings, layout_t *layout);
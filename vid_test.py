@@ -1,8 +1,11 @@
 from subprocess import Popen, PIPE
 from argparse import ArgumentParser
+from fractions import Fraction
+import json
 import math
+import os
 import random
-import itertools
+import struct
 from termcolor import colored
 
 FAIL = '\033[91m\033[1m'
@@ -10,23 +13,387 @@ GREEN = '\033[32m\033[1m'
 ENDC = '\033[0m'
 BOLD = '\033[1m'
 
+# Builds of the kernel test: all instruction sets, each of them also with the kernels verifying themselves
+KERNEL_FLAGS = [isa + verify for isa in (['-march=native'], ['-march=native', '-mno-avx512f'], ['-march=x86-64'])
+                for verify in ([], ['-DVERIFY_KERNEL'])]
+
+
+def reference(altitudes, observer=0):
+    # The slopes are compared as the exact fractions, the arctan of them is monotonic
+    visibilities = ['_'] * len(altitudes)
+    for direction, end in ((1, len(altitudes)), (-1, -1)):
+        maximum = None
+        for i in range(observer + direction, end, direction):
+            slope = Fraction(altitudes[i] - altitudes[observer], abs(i - observer))
+            visibilities[i] = "v" if maximum is None or slope > maximum else "u"
+            maximum = slope if maximum is None else max(maximum, slope)
+    return ','.join(visibilities)
+
+
+def check(name, output, ref_output):
+    if output != ref_output:
+        print(colored(name, "red"))
+        print(colored(ref_output, "red"))
+        print(colored(output, "red"))
+        print("------------------------------------")
+        return 1
+    return 0
+
+
+# File of the binary profiles written by the tests
+PROFILE = 'vid_test.bin'
+
+
+def write_profile(altitudes, observer=0):
+    # Header of the binary profile (magic, element type, count, observer, reserved) followed by the 32-bit altitudes
+    with open(PROFILE, 'wb') as profile:
+        profile.write(b'LOSP' + struct.pack('<IQQQ', 1, len(altitudes), observer, 0))
+        profile.write(struct.pack('<%di' % len(altitudes), *altitudes))
+
+
+def random_altitudes(count):
+    return [random.randint(-1024, 1024) for _ in range(count)]
+
+
+def run(argv, processes, options, data=b'', errors=False):
+    # Runs the program with the given options and the standard input, returns its standard output (and its error
+    # output); the zero cost model keeps all processes participating, the default one would park them for the short
+    # lines
+    args = [argv.mpi, '--hostfile', 'hostfile', '-np', str(processes), argv.executable, '-m', '0,0'] + options
+    process = Popen(args, stdin=PIPE, stdout=PIPE, stderr=PIPE)
+    outputs = process.communicate(data)
+    return outputs if errors else outputs[0]
+
+
+def test_server(argv):
+    # The server answers each line of sight of the standard input by the line of the results
+    lines = [random_altitudes(count) for count in (2, 5, 64, 65, 1000, 3)]
+    data = ''.join(','.join(map(str, altitudes)) + '\n' for altitudes in lines)
+    ref_output = ''.join(reference(altitudes) + '\n' for altitudes in lines)
+    failures = 0
+    for options in (['-S'], ['-S', '-f', '-s', 'lookback']):
+        output = run(argv, 4, options, data.encode()).decode('utf-8')
+        failures += check("[Server]: " + ' '.join(options), output, ref_output)
+    return failures
+
+
+def test_observer(argv):
+    # The observer placed inside the line of sight sees to both directions
+    failures = 0
+    for count in (2, 7, 65, 1000):
+        altitudes = random_altitudes(count)
+        for observer in (0, count // 2, count - 1):
+            for processes in (1, 4):
+                output = run(argv, processes, ['-x', str(observer), '--', ','.join(map(str, altitudes))])
+                failures += check("[Observer]: " + str(observer) + " [Processes]: " + str(processes),
+                                  output.decode('utf-8').rstrip('\n'), reference(altitudes, observer))
+    return failures
+
+
+def test_incremental(argv):
+    # The appended and changed altitudes are followed by the queries of the whole results
+    altitudes, commands, ref_outputs = [], [], []
+    for step in range(40):
+        if step % 4 == 0 or not altitudes:
+            # The first append has more altitudes, the single one is padded by the program to the two points
+            appended = random_altitudes(random.choice([1, 3, 100, 5000]) if altitudes else 3)
+            altitudes += appended
+            commands.append('+' + ','.join(map(str, appended)))
+            ref_outputs.append(str(len(altitudes)))
+        elif step % 4 != 3:
+            # The response of the change is the number of the recomputed blocks, which is not checked
+            index, altitudes[index] = random.randrange(len(altitudes)), random.randint(-1024, 1024)
+            commands.append('=%d,%d' % (index, altitudes[index]))
+            ref_outputs.append(None)
+        else:
+            commands.append('?')
+            ref_outputs.append(reference(altitudes))
+    # The incremental server runs on the one process only
+    outputs = run(argv, 1, ['-I'], ('\n'.join(commands) + '\n').encode()).decode('utf-8').split('\n')
+    failures = check("[Incremental]: responses", str(len(outputs) - 1), str(len(commands)))
+    for command, output, ref_output in zip(commands, outputs, ref_outputs):
+        if ref_output is not None:
+            failures += check("[Incremental]: " + command[:20], output, ref_output)
+    return failures
+
+
+def round_divide(dividend, divisor):
+    # The quotient is rounded to the nearest integer, the halves away from zero
+    if dividend >= 0:
+        return (2 * dividend + divisor) // (2 * divisor)
+    return -((-2 * dividend + divisor) // (2 * divisor))
+
+
+def viewshed(grid, width, observer):
+    # The rays are cast from the observer to all cells of the border of the grid
+    height = len(grid) // width
+    visible = [0] * len(grid)
+    visible[observer] = 1
+    border = [(x, y) for y in range(height) for x in range(width) if y in (0, height - 1) or x in (0, width - 1)]
+    observer_x, observer_y = observer % width, observer // width
+    for target_x, target_y in border:
+        dx, dy = target_x - observer_x, target_y - observer_y
+        steps = max(abs(dx), abs(dy))
+        maximum = None
+        for step in range(1, steps + 1):
+            cell = (observer_y + round_divide(step * dy, steps)) * width + observer_x + round_divide(step * dx, steps)
+            slope = Fraction(grid[cell] - grid[observer], step)
+            if maximum is None or slope > maximum:
+                visible[cell] = 1
+            maximum = slope if maximum is None else max(maximum, slope)
+    return visible
+
+
+def test_grid(argv):
+    # The viewshed is written as the plain PBM image of the visible cells
+    failures = 0
+    for width, height in ((1, 1), (9, 1), (1, 7), (5, 5), (37, 23)):
+        grid = random_altitudes(width * height)
+        observer = random.randrange(width * height)
+        write_profile(grid, observer)
+        visible = viewshed(grid, width, observer)
+        rows = [''.join(map(str, visible[y * width:(y + 1) * width])) for y in range(height)]
+        ref_output = 'P1\n%d %d\n' % (width, height) + ''.join(row + '\n' for row in rows)
+        output = run(argv, 3, ['-g', str(width), '-i', PROFILE]).decode('utf-8')
+        failures += check("[Grid]: %dx%d" % (width, height), output, ref_output)
+    os.remove(PROFILE)
+    return failures
+
+
+def test_tiled(argv):
+    # The profile is streamed by the tiles, the results are written per tile; the tiles are rounded up to the words
+    failures = 0
+    for count in (2, 63, 1000, 5000):
+        altitudes = random_altitudes(count)
+        write_profile(altitudes)
+        for tile in (1, 100, 4096):
+            output = run(argv, 1, ['-T', str(tile), '-i', PROFILE]).decode('utf-8').rstrip('\n')
+            failures += check("[Tiled]: %d by %d" % (count, tile), output, reference(altitudes))
+    os.remove(PROFILE)
+    return failures
+
+
+def test_benchmark(argv):
+    # The benchmark writes out the valid JSON with the statistics of all phases for each measured number of processes
+    failures = 0
+    for scan in ('tree', 'lookback'):
+        output = run(argv, 3, ['-s', scan, '-b', '2']).decode('utf-8')
+        try:
+            statistics = json.loads(output)
+            runs = statistics['runs']
+            valid = statistics['repetitions'] == 2 and statistics['scan'] == scan and runs
+            valid = valid and {measured['p'] for measured in runs} == {1, 2, 3}
+            for measured in runs:
+                valid = valid and all(0 <= phase['median_us'] <= phase['p99_us'] for phase in
+                                      measured['phases'].values())
+        except (ValueError, KeyError, TypeError):
+            valid = False
+        failures += check("[Benchmark]: " + scan, "valid" if valid else output[:200], "valid")
+    return failures
+
+
+def test_telemetry(argv):
+    # The telemetry does not change the results, each process reports its phases to the table and to the trace
+    processes, trace = 4, 'vid_test.json'
+    altitudes = random_altitudes(1000)
+    output, errors = run(argv, processes, ['-r', '-R', trace, '--', ','.join(map(str, altitudes))], errors=True)
+    failures = check("[Telemetry]: results", output.decode('utf-8').rstrip('\n'), reference(altitudes))
+    # Rows of the table are the rank, the node, the phase and four measured values
+    rows = [line.split() for line in errors.decode('utf-8').splitlines()]
+    phases = {(int(row[0]), row[2]) for row in rows if len(row) == 7 and row[0].isdigit()}
+    failures += check("[Telemetry]: table", str(sorted(rank for rank, phase in phases if phase == 'prescan')),
+                      str(list(range(processes))))
+    try:
+        with open(trace) as file:
+            events = json.load(file)['traceEvents']
+        ranks = sorted({event['tid'] for event in events if event['name'] == 'prescan' and event['dur'] >= 0})
+    except (OSError, ValueError, KeyError):
+        ranks = None
+    failures += check("[Telemetry]: trace", str(ranks), str(list(range(processes))))
+    if os.path.exists(trace):
+        os.remove(trace)
+    return failures
+
+
+def test_threads(argv):
+    # The multithreaded backend without MPI is tested, when its executable is given
+    if not argv.threads:
+        return 0
+    failures, text = 0, 'vid_test.csv'
+    # The longest line of sight is split to several chunks of THREAD_CHUNK altitudes, thus to several threads
+    for count in (2, 7, 65, 1000, 300000):
+        altitudes = random_altitudes(count)
+        source = ['--', ','.join(map(str, altitudes))]
+        if count > 1000:
+            # The long line of sight does not fit to the command line
+            with open(text, 'w') as file:
+                file.write(source[1])
+            source = ['-t', text]
+        for observer in (0, count // 3):
+            ref_output = reference(altitudes, observer)
+            for threads in (1, 2, 5):
+                process = Popen([argv.threads, '-j', str(threads), '-x', str(observer)] + source,
+                                stdout=PIPE, stderr=PIPE)
+                output = process.communicate()[0].decode('utf-8').rstrip('\n')
+                failures += check("[Threads]: %d of %d from %d" % (threads, count, observer), output, ref_output)
+    os.remove(text)
+    return failures
+
+
+def test_element(argv):
+    # The written profile stores the altitudes of the selected type, the results read from it are the same
+    failures = 0
+    for element, element_type in (('int32', 1), ('int16', 2)):
+        for observer in (0, 321):
+            altitudes = random_altitudes(1000)
+            run(argv, 2, ['-e', element, '-x', str(observer), '-w', PROFILE, '--', ','.join(map(str, altitudes))])
+            with open(PROFILE, 'rb') as profile:
+                header = profile.read(32)
+            failures += check("[Element]: header " + element, str(header[:8]),
+                              str(b'LOSP' + struct.pack('<I', element_type)))
+            output = run(argv, 4, ['-i', PROFILE]).decode('utf-8').rstrip('\n')
+            failures += check("[Element]: " + element, output, reference(altitudes, observer))
+    os.remove(PROFILE)
+    return failures
+
+
+def test_placement(argv):
+    # The placement of the windows does not change the results of any pipeline
+    failures = 0
+    altitudes = random_altitudes(5000)
+    write_profile(altitudes)
+    for placement in ('local', 'huge'):
+        for pipeline in (['-s', 'tree'], ['-s', 'lookback'], ['-f', '-s', 'lookback']):
+            for source in (['--', ','.join(map(str, altitudes))], ['-i', PROFILE]):
+                output = run(argv, 4, ['-P', placement] + pipeline + source).decode('utf-8').rstrip('\n')
+                failures += check("[Placement]: " + ' '.join([placement] + pipeline + source[:1]), output,
+                                  reference(altitudes))
+    os.remove(PROFILE)
+    return failures
+
+
+def pack_bits(visibilities):
+    # Bit i % 64 of the 64-bit word i / 64 is set for the visible point i
+    words = [0] * ((len(visibilities) + 63) // 64)
+    for i, visibility in enumerate(visibilities):
+        if visibility == 'v':
+            words[i // 64] |= 1 << (i % 64)
+    return struct.pack('<%dQ' % len(words), *words)
+
+
+def test_observers(argv):
+    # The text output is the number of the visible points of each observer, the raw output their bitsets
+    failures = 0
+    for count in (2, 65, 3000):
+        altitudes = random_altitudes(count)
+        observers = [random.randrange(count) for _ in range(20)] + [0, count - 1]
+        references = [reference(altitudes, observer).split(',') for observer in observers]
+        options = ['-X', ','.join(map(str, observers)), '--', ','.join(map(str, altitudes))]
+        output = run(argv, 3, options).decode('utf-8')
+        ref_output = ''.join('%d %d\n' % (observer, visibilities.count('v'))
+                             for observer, visibilities in zip(observers, references))
+        failures += check("[Observers]: text of %d" % count, output, ref_output)
+        ref_output = b''.join(pack_bits(visibilities) for visibilities in references)
+        output = run(argv, 3, ['-o', 'raw'] + options)
+        failures += check("[Observers]: raw of %d" % count, output.hex(), ref_output.hex())
+    return failures
+
+
+def summaries(altitudes, observer, step):
+    # Reference summaries of the results, the visible intervals, their count, the furthest visible point and the
+    # horizon (the maximum slope up to each STEP-th point and the last one)
+    visible = [i for i, visibility in enumerate(reference(altitudes, observer).split(',')) if visibility == 'v']
+    intervals = []
+    for i in visible:
+        if intervals and intervals[-1][1] + 1 == i:
+            intervals[-1][1] = i
+        else:
+            intervals.append([i, i])
+    # The furthest point prefers the right side of the observer at the same distance
+    furthest = max(visible, key=lambda i: (abs(i - observer), i > observer), default=-1)
+    horizon, maximum = [], None
+    for i in range(1, len(altitudes)):
+        slope = Fraction(altitudes[i] - altitudes[0], i)
+        maximum = slope if maximum is None else max(maximum, slope)
+        if i % step == 0 or i == len(altitudes) - 1:
+            horizon.append((i, maximum))
+    return {'intervals': ''.join('%d %d\n' % tuple(interval) for interval in intervals),
+            'count': '%d\n' % len(visible), 'furthest': '%d\n' % furthest}, horizon
+
+
+def test_summary(argv):
+    # The summaries are merged from the parts of all processes
+    failures = 0
+    for count in (2, 65, 5000):
+        altitudes = random_altitudes(count)
+        line_of_sight = ','.join(map(str, altitudes))
+        for observer in (0, count // 2, count - 1):
+            ref_outputs, horizon = summaries(altitudes, observer, 7)
+            for kind, ref_output in ref_outputs.items():
+                output = run(argv, 4, ['-q', kind, '-x', str(observer), '--', line_of_sight]).decode('utf-8')
+                failures += check("[Summary]: %s of %d from %d" % (kind, count, observer), output, ref_output)
+        # The horizon is written by the floating point slopes, they are compared with the relative tolerance
+        output = run(argv, 4, ['-q', 'horizon:7', '--', line_of_sight]).decode('utf-8').split()
+        points = [(int(output[i]), float(output[i + 1])) for i in range(0, len(output) - 1, 2)]
+        valid = len(points) == len(horizon) and all(point[0] == i and abs(point[1] - slope) <= 1e-7 * max(1, abs(
+            slope)) for point, (i, slope) in zip(points, horizon))
+        failures += check("[Summary]: horizon of %d" % count, "valid" if valid else ' '.join(output[:10]), "valid")
+    return failures
+
+
+# Tests of the modes of the program, each of them returns the number of its failures
+MODE_TESTS = [test_server, test_observer, test_incremental, test_grid, test_tiled, test_benchmark, test_telemetry,
+              test_threads, test_element, test_placement, test_observers, test_summary]
+
+
+def test_kernels(compiler):
+    # The kernels are compared bit for bit with the scalar reference of the kernel test
+    failures = 0
+    for flags in KERNEL_FLAGS:
+        build = Popen([compiler, '-O2'] + flags + ['-o', 'kernel_test', 'kernel_test.cpp', 'kernel.cpp'],
+                      stdout=PIPE, stderr=PIPE)
+        if build.wait() != 0:
+            print(colored("[Kernels]: build failed with " + ' '.join(flags), "red"))
+            failures += 1
+            continue
+        test = Popen(['./kernel_test'], stdout=PIPE, stderr=PIPE)
+        output, errors = test.communicate()
+        print("[Kernels]: ", ' '.join(flags), output.decode('utf-8').strip())
+        if test.returncode != 0:
+            print(colored(errors.decode('utf-8'), "red"))
+            failures += 1
+    # The built kernel test is removed as test.sh does with its binary
+    if os.path.exists('kernel_test'):
+        os.remove('kernel_test')
+    return failures
+
 
 def main():
     parser = ArgumentParser()
     parser.add_argument("-m", "--mpi", type=str, default="mpirun")
     parser.add_argument("-e", "--executable", type=str, default="vid")
     parser.add_argument("-l", "--limit", type=int, default=15)
+    parser.add_argument("-a", "--arguments", type=str, default="")
+    parser.add_argument("-k", "--kernels", type=str, default="", help="compiler of the kernel test")
+    parser.add_argument("-t", "--threads", type=str, default="", help="executable of the multithreaded backend")
 
     argv = parser.parse_args()
+    failures = test_kernels(argv.kernels) if argv.kernels else 0
     if not argv.executable:
-        return
+        return failures
+
+    for test in MODE_TESTS:
+        failures += test(argv)
 
-    altitudes = [random.randint(1, 1024)]
+    # The altitudes are also negative, the slopes are differences of them; the line of sight starts
+    # with two altitudes, the output of the single one is padded by the program to the two points
+    altitudes = [random.randint(-1024, 1024), random.randint(-1024, 1024)]
 
-    args = [argv.mpi, '--hostfile', 'hostfile', '-np', '', argv.executable, '']
-    for inputSize in range(1, 31):
+    # All started processes participate in the max-prescan, the options given on the command line may override it
+    args = [argv.mpi, '--hostfile', 'hostfile', '-np', '', argv.executable, '-m', '0,0'] + argv.arguments.split()
+    args += ['--', '']
+    for inputSize in range(2, 31):
         print("[Input size]: ", inputSize)
-        # permutations = itertools.permutations(altitudes)
 
         for i in range(0, min(argv.limit, math.factorial(inputSize))):
             if i == 0:
@@ -36,30 +403,20 @@ def main():
             else:
                 random.shuffle(altitudes)
 
-            args[6] = ','.join(map(str, altitudes))
-            print("[Input string]: ", {args[6]})
-            angles = [-math.inf] + [math.atan((x - altitudes[0]) / float(i))
-                    for i, x in enumerate(altitudes[1:], 1)]
-
-            max_prescan = [-math.inf] + list(itertools.accumulate(angles, max))
-            max_prescan.pop()
-            visibilities = ["v" if (angle > max_prev_angle) else "u"
-                            for (angle, max_prev_angle) in zip(angles, max_prescan)]
-            visibilities[0] = "_"
-
-            ref_output = ",".join(visibilities)
+            args[-1] = ','.join(map(str, altitudes))
+            print("[Input string]: ", {args[-1]})
+            ref_output = reference(altitudes)
             for procCount in range(1, inputSize + 1):
                 args[4] = str(procCount)
                 process = Popen(args, stdout=PIPE, stderr=PIPE)
                 output = process.communicate()[0].decode('utf-8').rstrip('\n')
-                if output != ref_output:
-                    print(colored(ref_output, "red"))
-                    print(colored(output, "red"))
-                    print(procCount)
-                    print("------------------------------------")
+                failures += check("[Processes]: " + str(procCount), output, ref_output)
+
+        altitudes.append(random.randint(-1024, 1024))
 
-        altitudes.append(random.randint(1, 1024))
+    print(colored("[Failures]: " + str(failures), "red" if failures else "green"))
+    return failures
 
 
 if __name__ == "__main__":
-    main()
+    exit(1 if main() else 0)
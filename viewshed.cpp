@@ -0,0 +1,159 @@
+/**************************************************************
+ * File:		viewshed.cpp
+ * Author:		Šimon Stupinský
+ * University: 	Brno University of Technology
+ * Faculty: 	Faculty of Information Technology
+ * Course:	    Parallel and Distributed Algorithms
+ * Date:		17.10.2026
+ * Last change:	17.10.2026
+ *
+ * Subscribe:	The viewshed module of the program implementing Line-of-Sight problem.
+ *
+**************************************************************/
+
+/**
+ * @file    viewshed.cpp
+ * @brief   This module contains the implementation of the radial viewshed over the grid
+ *          of the altitudes. The rays are cast from the observer to all cells of the
+ *          border of the grid (R2 sweep) and each ray is solved as the line of sight
+ *          of the altitudes sampled along it. The rays are distributed to the processes
+ *          dynamically by the shared counter of the master process.
+ */
+
+
+#include "vid.h"
+
+
+long long count_rays(int width, int height) {
+    // The top and the bottom row, each of the other rows contributes its first and its last cell
+    return (long long) width * std::min(height, 2) + (long long) std::max(height - 2, 0) * std::min(width, 2);
+}
+
+int ray_target(int width, int height, long long ray) {
+    // Cells of the top row
+    if (ray < width) {
+        return ray;
+    }
+    ray -= width;
+    // Cells of the bottom row
+    if (height > 1 && ray < width) {
+        return (height - 1) * width + ray;
+    }
+    ray -= (height > 1) ? width : 0;
+    // The first and the last cell of each row between them
+    int sides = std::min(width, 2);
+    return (1 + ray / sides) * width + ((ray % sides) ? width - 1 : 0);
+}
+
+/**
+ * Divides the given numbers and rounds the quotient to the nearest integer (the halves away from zero).
+ */
+static long long round_divide(long long dividend, long long divisor) {
+    return (dividend >= 0) ? (2 * dividend + divisor) / (2 * divisor) : -((-2 * dividend + divisor) / (2 * divisor));
+}
+
+size_t sample_ray(
+    const int *grid, int width, int observer, int target, std::vector<int> *altitudes, std::vector<int> *cells
+) {
+    // Offset of the target from the observer and the number of the steps along the longer axis
+    long long observer_x = observer % width, observer_y = observer / width;
+    long long dx = target % width - observer_x, dy = target / width - observer_y;
+    long long steps = std::max(std::abs(dx), std::abs(dy));
+    altitudes->resize(steps + 1);
+    cells->resize(steps + 1);
+    // The step along the longer axis moves exactly by one cell, the other coordinate is rounded
+    for (long long step = 0; step <= steps; step++) {
+        long long x = observer_x + (steps ? round_divide(step * dx, steps) : 0);
+        long long y = observer_y + (steps ? round_divide(step * dy, steps) : 0);
+        (*cells)[step] = y * width + x;
+        (*altitudes)[step] = grid[(*cells)[step]];
+    }
+    return steps + 1;
+}
+
+int compute_viewshed(const settings_t *settings, layout_t *layout) {
+    // Each process maps the whole grid, the rays may cross any of its cells
+    profile_t profile;
+    int observer_altitude;
+    if (!map_profile(settings->input, &profile, &observer_altitude, layout)) {
+        return 1;
+    }
+    // The profile stores the grid by the rows, thus its size has to be the multiple of the width
+    const char *error = nullptr;
+    if (settings->grid_width > layout->total_altitudes || layout->total_altitudes % settings->grid_width) {
+        error = "the profile is not the grid of the given width";
+    } else if (settings->observer >= layout->total_altitudes) {
+        error = "the observer is out of the grid";
+    } else if (profile.header->element_type != PROFILE_INT32) {
+        error = "unsupported element type of the grid";
+    }
+    if (error) {
+        report_error(error, layout->world_rank);
+        close_profile(&profile);
+        return 1;
+    }
+    int width = settings->grid_width, height = layout->total_altitudes / width;
+    // The observer given on the command line overrides the observer of the profile
+    const int *grid = (const int *) profile.altitudes;
+    if (settings->observer >= 0) {
+        layout->observer = settings->observer;
+        observer_altitude = grid[layout->observer];
+    }
+
+    // Create the window of the counter of the assigned rays, only the master process stores it
+    long long *counter;
+    MPI_Win node_counter;
+    MPI_Win_allocate(
+            (layout->world_rank == MASTER) ? sizeof(long long) : 0, sizeof(long long), MPI_INFO_NULL,
+            MPI_COMM_WORLD, &counter, &node_counter
+    );
+    if (layout->world_rank == MASTER) {
+        *counter = 0;
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    // Each process combines the visibilities of the cells on its rays to its own raster
+    std::vector<uint64_t> raster(RESULT_WORDS(layout->total_altitudes), 0);
+    std::vector<uint64_t> visible;
+    std::vector<int> altitudes, cells;
+    long long rays = count_rays(width, height), chunk = VIEWSHED_CHUNK, first;
+    MPI_Win_lock_all(0, node_counter);
+    while (true) {
+        // Atomically obtain the next chunk of the rays, the faster processes thus process more rays
+        MPI_Fetch_and_op(&chunk, &first, MPI_LONG_LONG, MASTER, 0, MPI_SUM, node_counter);
+        MPI_Win_flush(MASTER, node_counter);
+        if (first >= rays) {
+            break;
+        }
+        for (long long ray = first; ray < std::min(first + chunk, rays); ray++) {
+            // The distance of the sample is its step along the ray, it preserves the order of the slopes on the ray
+            size_t samples = sample_ray(
+                    grid, width, layout->observer, ray_target(width, height, ray), &altitudes, &cells
+            );
+            visible.assign(RESULT_WORDS(samples), 0);
+            sweep_slopes(altitudes.data(), observer_altitude, 0, samples, SLOPE_MIN, visible.data(), 0);
+            // The cell is visible, when it is visible on any ray crossing it
+            for (size_t i = 1; i < samples; i++) {
+                if (result_bit(visible.data(), i)) {
+                    raster[cells[i] / WORD_BITS] |= 1ULL << (cells[i] % WORD_BITS);
+                }
+            }
+        }
+    }
+    MPI_Win_unlock_all(node_counter);
+    MPI_Win_free(&node_counter);
+
+    // The cell of the observer is visible, the master process combines the rasters of all processes
+    raster[layout->observer / WORD_BITS] |= 1ULL << (layout->observer % WORD_BITS);
+    MPI_Reduce(
+            (layout->world_rank == MASTER) ? MPI_IN_PLACE : raster.data(), raster.data(), raster.size(),
+            MPI_UINT64_T, MPI_BOR, MASTER, MPI_COMM_WORLD
+    );
+    if (layout->world_rank == MASTER) {
+        if (!write_raster(stdout, raster.data(), width, height, settings->output == OUTPUT_RAW)) {
+            report_error("cannot write out the results", layout->world_rank);
+        }
+    }
+    close_profile(&profile);
+    return 0;
+}